@@ -39,4 +39,11 @@ list(APPEND path_planning_LIBRARIES ${GFLAGS_LIBRARIES})
 # Find Google-glog.
 include("cmake/External/glog.cmake")
 include_directories(SYSTEM ${GLOG_INCLUDE_DIRS})
-list(APPEND path_planning_LIBRARIES ${GLOG_LIBRARIES})
\ No newline at end of file
+list(APPEND path_planning_LIBRARIES ${GLOG_LIBRARIES})
+
+# Find OpenMP (optional). Used to parallelize batched queries.
+find_package( OpenMP )
+if (OPENMP_FOUND)
+  set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}")
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}")
+endif (OPENMP_FOUND)
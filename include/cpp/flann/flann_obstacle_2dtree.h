@@ -69,11 +69,16 @@ namespace path {
     // and distance to the nearest neighbor.
     bool NearestNeighbor(Point2D::Ptr query, Obstacle2D::Ptr& nearest,
                          float& nn_distance) const;
+    bool NearestNeighbor(const Point2D::Value& query, Obstacle2D::Ptr& nearest,
+                         float& nn_distance) const;
 
     // Queries the kd tree for all neighbors of 'query' within the specified radius.
     // Returns whether or not the search exited successfully.
     bool RadiusSearch(Point2D::Ptr query, std::vector<Obstacle2D::Ptr>& neighbors,
                       float radius) const;
+    bool RadiusSearch(const Point2D::Value& query,
+                      std::vector<Obstacle2D::Ptr>& neighbors,
+                      float radius) const;
 
   private:
     FlannPoint2DTree kd_tree_;
@@ -62,8 +62,9 @@ namespace path {
     // Number of points in the tree.
     int Size() const;
 
-    // Add points to the index.
+    // Add points to the index. Points are numbered in insertion order.
     void AddPoint(Point2D::Ptr point);
+    void AddPoint(const Point2D::Value& point);
     void AddPoints(std::vector<Point2D::Ptr>& points);
 
     // Queries the kd tree for the nearest neighbor of 'query'. Returns whether or
@@ -71,11 +72,32 @@ namespace path {
     // and distance to the nearest neighbor.
     bool NearestNeighbor(Point2D::Ptr query, Point2D::Ptr& nearest,
                          float& nn_distance) const;
+    bool NearestNeighbor(const Point2D::Value& query, Point2D::Ptr& nearest,
+                         float& nn_distance) const;
+    bool NearestNeighbor(const Point2D::Value& query, int& nearest_index,
+                         float& nn_distance) const;
 
     // Queries the kd tree for all neighbors of 'query' within the specified radius.
     // Returns whether or not the search exited successfully.
     bool RadiusSearch(Point2D::Ptr query, std::vector<Point2D::Ptr>& neighbors,
                       float radius) const;
+    bool RadiusSearch(const Point2D::Value& query,
+                      std::vector<Point2D::Ptr>& neighbors,
+                      float radius) const;
+
+    // Batched queries, answered with a single FLANN matrix query. Results go
+    // into caller-provided buffers, which are resized to fit. Nearest
+    // neighbor results hold one entry per query (index -1 if none). Radius
+    // results are stored CSR-style: the neighbors of query ii are
+    // neighbors[offsets[ii]] .. neighbors[offsets[ii + 1] - 1]. If 'parallel'
+    // is set, FLANN spreads the queries across all cores.
+    bool NearestNeighbors(const std::vector<Point2D::Value>& queries,
+                          std::vector<int>& nearest_indices,
+                          std::vector<float>& nn_distances,
+                          bool parallel = false) const;
+    bool RadiusSearch(const std::vector<Point2D::Value>& queries,
+                      std::vector<int>& offsets, std::vector<int>& neighbors,
+                      float radius, bool parallel = false) const;
 
   private:
     std::shared_ptr< flann::Index< flann::L2<double> > > index_;
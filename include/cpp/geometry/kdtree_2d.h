@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines an incremental kd tree over 2D points, tuned for
+// insert-heavy workloads such as growing an RRT. It is a log-structured
+// forest: new points land in a small unsorted buffer, and whenever the
+// buffer fills it is merged with the smaller trees into a single balanced
+// tree, the way a binary counter carries. Each tree is static and stored
+// implicitly in a flat array, so there are no per-node allocations and
+// queries never touch the heap. Queries are exact.
+//
+// Every point is merged O(log n) times, and building a balanced tree over
+// m points costs O(m log m), so insertion is amortized O(log^2 n), not
+// O(log n). Keeping levels presorted would make the carry's merge linear,
+// but the build would still partition every range on the other axis, so
+// the bound would not change. With 32-point buffers the extra log factor
+// is small in practice.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_KDTREE_2D_H
+#define PATH_PLANNING_KDTREE_2D_H
+
+#include <geometry/point_2d.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class KdTree2D {
+  public:
+    KdTree2D() : num_buffered_(0), num_removed_(0) {}
+    ~KdTree2D() {}
+
+    // Number of points in the tree.
+    int Size() const;
+
+    // Add points to the index. Points are numbered in insertion order. Each
+    // point may carry a non-negative extent (e.g. the radius of the object
+    // it represents), which only ExtentVisit() looks at.
+    int AddPoint(const Point2D::Value& point, float extent = 0.0);
+    void AddPoints(const std::vector<Point2D::Value>& points);
+
+    // Get a point, or its extent, by index.
+    const Point2D::Value& GetPoint(int index) const;
+    float GetExtent(int index) const;
+
+    // Remove all points.
+    void Clear();
+
+    // Remove a single point, or restore a removed one. Removed points keep
+    // their index and stay in the trees as tombstones, but no query returns
+    // them. Many tombstones slow queries down, since they are still visited.
+    void Remove(int index);
+    void Restore(int index);
+    bool IsRemoved(int index) const;
+
+    // Queries the kd tree for the nearest neighbor of 'query'. Returns whether or
+    // not a nearest neighbor was found, and if it was found, the index of the
+    // nearest neighbor and the distance to it.
+    bool NearestNeighbor(const Point2D::Value& query, int& nearest_index,
+                         float& nn_distance) const;
+
+    // Queries the kd tree for all neighbors of 'query' within the specified
+    // radius. Clears 'neighbors' and fills it with their indices. Returns whether
+    // or not any neighbors were found.
+    bool RadiusSearch(const Point2D::Value& query, std::vector<int>& neighbors,
+                      float radius) const;
+
+    // Batched queries. Results go into caller-provided buffers, which are
+    // resized to fit and can be reused across calls to avoid reallocating.
+    // Nearest neighbor results hold one entry per query, with index -1 and
+    // infinite distance when the tree is empty. Radius results are stored
+    // CSR-style: the neighbors of query ii are
+    // neighbors[offsets[ii]] .. neighbors[offsets[ii + 1] - 1].
+    // If 'parallel' is set, queries are spread across cores with OpenMP.
+    void NearestNeighbors(const std::vector<Point2D::Value>& queries,
+                          std::vector<int>& nearest_indices,
+                          std::vector<float>& nn_distances,
+                          bool parallel = false) const;
+    void RadiusSearch(const std::vector<Point2D::Value>& queries,
+                      std::vector<int>& offsets, std::vector<int>& neighbors,
+                      float radius, bool parallel = false) const;
+
+    // Calls 'visitor(index)' for every point within 'radius' of 'query'. This
+    // never allocates, so it is the preferred query in inner loops.
+    template <typename Visitor>
+    void RadiusVisit(const Point2D::Value& query, float radius,
+                     Visitor visitor) const;
+
+    // Calls 'visitor(index)' for every point p within
+    // 'offset' + 'extent_scale' * extent(p) of 'query'. Each split stores the
+    // largest extent below it, so one large point only widens the search in
+    // the part of the tree that holds it.
+    template <typename Visitor>
+    void ExtentVisit(const Point2D::Value& query, float offset,
+                     float extent_scale, Visitor visitor) const;
+
+  private:
+    // One entry of a static tree. For splitting entries, 'max_extent' is the
+    // largest extent in the range the entry splits.
+    struct Entry {
+      float x;
+      float y;
+      int index;
+      float extent;
+      float max_extent;
+    };
+
+    // Ranges at most this long are scanned linearly.
+    static const size_t kLeafSize = 8;
+
+    // Number of points collected before they are merged into a tree.
+    static const size_t kBufferSize = 32;
+
+    // All points, in insertion order. The last 'num_buffered_' of them are
+    // not yet part of any tree.
+    std::vector<Point2D::Value> points_;
+    std::vector<float> extents_;
+    size_t num_buffered_;
+
+    // Tombstones, one per point.
+    std::vector<uint8_t> removed_;
+    size_t num_removed_;
+
+    // Tree k is either empty or holds kBufferSize * 2^k entries, laid out so
+    // that the median of every range (alternating x and y with depth) sits
+    // at the middle of the range.
+    std::vector< std::vector<Entry> > trees_;
+
+    // Merge the buffer and all smaller trees into the first empty tree.
+    void Carry();
+
+    // Arrange entries [begin, end) into an implicit kd tree. Returns the
+    // largest extent in the range.
+    static float Build(std::vector<Entry>& entries, size_t begin, size_t end,
+                      int depth);
+
+    // Recursive queries on one tree.
+    // 'removed' is null when there are no tombstones.
+    static void NearestNeighbor(const std::vector<Entry>& entries,
+                                size_t begin, size_t end, int depth,
+                                const Point2D::Value& query,
+                                const uint8_t* removed,
+                                int& nearest_index, float& nn_distance_sq);
+
+    template <typename Visitor>
+    static void RadiusVisit(const std::vector<Entry>& entries,
+                            size_t begin, size_t end, int depth,
+                            const Point2D::Value& query, float radius_sq,
+                            Visitor& visitor);
+
+    template <typename Visitor>
+    static void ExtentVisit(const std::vector<Entry>& entries,
+                            size_t begin, size_t end, int depth,
+                            const Point2D::Value& query, float offset,
+                            float extent_scale, Visitor& visitor);
+
+    DISALLOW_COPY_AND_ASSIGN(KdTree2D);
+  };
+
+  // ------------------- Implementation ------------------- //
+
+  template <typename Visitor>
+  void KdTree2D::RadiusVisit(const Point2D::Value& query, float radius,
+                             Visitor visitor) const {
+    const float radius_sq = radius * radius;
+
+    // Skip tombstones.
+    auto live = [this, &visitor](int index) {
+      if (num_removed_ == 0 || !removed_[index])
+        visitor(index);
+    };
+
+    // Scan the buffer.
+    for (size_t ii = points_.size() - num_buffered_; ii < points_.size(); ii++) {
+      const float dx = points_[ii].x - query.x;
+      const float dy = points_[ii].y - query.y;
+      if (dx * dx + dy * dy <= radius_sq)
+        live(static_cast<int>(ii));
+    }
+
+    // Search each tree.
+    for (const auto& entries : trees_) {
+      if (!entries.empty())
+        RadiusVisit(entries, 0, entries.size(), 0, query, radius_sq, live);
+    }
+  }
+
+  template <typename Visitor>
+  void KdTree2D::RadiusVisit(const std::vector<Entry>& entries,
+                             size_t begin, size_t end, int depth,
+                             const Point2D::Value& query, float radius_sq,
+                             Visitor& visitor) {
+    // Small ranges are scanned linearly.
+    if (end - begin <= kLeafSize) {
+      for (size_t ii = begin; ii < end; ii++) {
+        const float dx = entries[ii].x - query.x;
+        const float dy = entries[ii].y - query.y;
+        if (dx * dx + dy * dy <= radius_sq)
+          visitor(entries[ii].index);
+      }
+
+      return;
+    }
+
+    // Check the splitting entry, then recurse on the sides the ball reaches.
+    const size_t middle = begin + (end - begin) / 2;
+    const Entry& split = entries[middle];
+    const float dx = split.x - query.x;
+    const float dy = split.y - query.y;
+    if (dx * dx + dy * dy <= radius_sq)
+      visitor(split.index);
+
+    const float offset = (depth & 1) ? query.y - split.y : query.x - split.x;
+    if (offset <= 0.0 || offset * offset <= radius_sq)
+      RadiusVisit(entries, begin, middle, depth + 1, query, radius_sq, visitor);
+    if (offset >= 0.0 || offset * offset <= radius_sq)
+      RadiusVisit(entries, middle + 1, end, depth + 1, query, radius_sq, visitor);
+  }
+
+  template <typename Visitor>
+  void KdTree2D::ExtentVisit(const Point2D::Value& query, float offset,
+                             float extent_scale, Visitor visitor) const {
+    // Skip tombstones.
+    auto live = [this, &visitor](int index) {
+      if (num_removed_ == 0 || !removed_[index])
+        visitor(index);
+    };
+
+    // Scan the buffer.
+    for (size_t ii = points_.size() - num_buffered_; ii < points_.size(); ii++) {
+      const float dx = points_[ii].x - query.x;
+      const float dy = points_[ii].y - query.y;
+      const float reach = offset + extent_scale * extents_[ii];
+      if (dx * dx + dy * dy <= reach * reach)
+        live(static_cast<int>(ii));
+    }
+
+    // Search each tree.
+    for (const auto& entries : trees_) {
+      if (!entries.empty())
+        ExtentVisit(entries, 0, entries.size(), 0, query, offset,
+                    extent_scale, live);
+    }
+  }
+
+  template <typename Visitor>
+  void KdTree2D::ExtentVisit(const std::vector<Entry>& entries,
+                             size_t begin, size_t end, int depth,
+                             const Point2D::Value& query, float offset,
+                             float extent_scale, Visitor& visitor) {
+    // Small ranges are scanned linearly.
+    if (end - begin <= kLeafSize) {
+      for (size_t ii = begin; ii < end; ii++) {
+        const float dx = entries[ii].x - query.x;
+        const float dy = entries[ii].y - query.y;
+        const float reach = offset + extent_scale * entries[ii].extent;
+        if (dx * dx + dy * dy <= reach * reach)
+          visitor(entries[ii].index);
+      }
+
+      return;
+    }
+
+    // Check the splitting entry.
+    const size_t middle = begin + (end - begin) / 2;
+    const Entry& split = entries[middle];
+    const float dx = split.x - query.x;
+    const float dy = split.y - query.y;
+    const float reach = offset + extent_scale * split.extent;
+    if (dx * dx + dy * dy <= reach * reach)
+      visitor(split.index);
+
+    // No point in this range reaches further than the largest extent in it.
+    const float max_reach = offset + extent_scale * split.max_extent;
+    const float max_reach_sq = max_reach * max_reach;
+    const float plane = (depth & 1) ? query.y - split.y : query.x - split.x;
+    if (plane <= 0.0 || plane * plane <= max_reach_sq)
+      ExtentVisit(entries, begin, middle, depth + 1, query, offset,
+                  extent_scale, visitor);
+    if (plane >= 0.0 || plane * plane <= max_reach_sq)
+      ExtentVisit(entries, middle + 1, end, depth + 1, query, offset,
+                  extent_scale, visitor);
+  }
+
+} //\ namespace path
+
+#endif
@@ -36,7 +36,9 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-// This class defines a Node in an N-ary tree of Point2D::Ptr types.
+// This class defines a Node in an N-ary tree of 2D points. Nodes live in a
+// contiguous arena owned by the tree and refer to each other by 32-bit
+// index: each node knows its parent, its first child, and its next sibling.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -45,49 +47,26 @@
 
 #include <geometry/point_2d.h>
 #include <util/types.h>
-#include <util/disallow_copy_and_assign.h>
 
-#include <memory>
-#include <vector>
-#include <glog/logging.h>
+#include <stdint.h>
 
 namespace path {
 
-  // Helper class for use with a tree class.
-  class Node2D {
-  public:
-    typedef std::shared_ptr<Node2D> Ptr;
+  // Plain node type for use with an arena-backed tree class.
+  struct Node2D {
+    typedef uint32_t Index;
 
-    ~Node2D() {}
+    // Sentinel for "no node", e.g. the parent of the root.
+    static const Index kNone = 0xFFFFFFFF;
 
-    // Factory method.
-    static Node2D::Ptr Create(const Point2D::Ptr data);
+    Point2D::Value point;
+    Index parent;
+    Index first_child;
+    Index next_sibling;
 
-    // Add a child.
-    void AddChild(Node2D::Ptr child);
-
-    // Set parent.
-    void SetParent(Node2D::Ptr parent);
-
-    // Get children.
-    std::vector<Node2D::Ptr>& GetChildren();
-
-    // Get parent.
-    Node2D::Ptr GetParent();
-
-    // Get data.
-    Point2D::Ptr GetData();
-
-  private:
-    Point2D::Ptr data_;
-    Node2D::Ptr parent_;
-    std::vector<Node2D::Ptr> children_;
-
-    // Private constructor. Use the factory method instead.
-    Node2D(const Point2D::Ptr data)
-      : data_(data) {}
-
-    DISALLOW_COPY_AND_ASSIGN(Node2D);
+    Node2D(const Point2D::Value& point, Index parent)
+      : point(point), parent(parent),
+        first_child(kNone), next_sibling(kNone) {}
   };
 
 } //\ namespace path
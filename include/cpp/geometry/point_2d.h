@@ -38,6 +38,10 @@
 //
 // This is a helper class to do various useful operations on Point2D objects.
 //
+// Every helper has two flavors: one on Point2D::Ptr and one on the plain
+// Point2D::Value type. The Ptr versions are thin adapters around the value
+// versions, which are inlined below and never touch the heap.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef PATH_PLANNING_POINT2D_HELPERS_H
@@ -45,6 +49,9 @@
 
 #include <util/types.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace path {
 
   // Helper functions for Point2D.
@@ -52,28 +59,115 @@ namespace path {
 
     // Create a Point2D.
     Point2D::Ptr Create(float x, float y);
+    Point2D::Ptr Create(const Point2D::Value& point);
 
     // Midpoint.
     Point2D::Ptr MidPoint(Point2D::Ptr point1, Point2D::Ptr point2);
+    inline Point2D::Value MidPoint(const Point2D::Value& point1,
+                                   const Point2D::Value& point2);
 
     // Distance between a point and this line segment.
     float DistanceLineToPoint(Point2D::Ptr point1,
                                      Point2D::Ptr point2,
                                      Point2D::Ptr point3);
+    inline float DistanceLineToPoint(const Point2D::Value& point1,
+                                     const Point2D::Value& point2,
+                                     const Point2D::Value& point3);
 
     // Distance between two points.
     float DistancePointToPoint(Point2D::Ptr point1,
                                       Point2D::Ptr point2);
+    inline float DistancePointToPoint(const Point2D::Value& point1,
+                                      const Point2D::Value& point2);
 
     // Take a step toward point2 from point1.
     Point2D::Ptr StepToward(Point2D::Ptr point1, Point2D::Ptr point2,
                                    float step_size);
+    inline Point2D::Value StepToward(const Point2D::Value& point1,
+                                     const Point2D::Value& point2,
+                                     float step_size);
 
     // Add two points with a scale factor.
     Point2D::Ptr Add(Point2D::Ptr point1, Point2D::Ptr point2,
                             float scale);
+    inline Point2D::Value Add(const Point2D::Value& point1,
+                              const Point2D::Value& point2,
+                              float scale);
   }; //\ namespace Point2D
 
+  // ------------------- Implementation ------------------- //
+
+  // Midpoint.
+  Point2D::Value Point2D::MidPoint(const Point2D::Value& point1,
+                                   const Point2D::Value& point2) {
+    return Point2D::Value(0.5 * (point1.x + point2.x),
+                          0.5 * (point1.y + point2.y));
+  }
+
+  // Distance between a the line segment between the first two points,
+  // and the third point.
+  float Point2D::DistanceLineToPoint(const Point2D::Value& point1,
+                                     const Point2D::Value& point2,
+                                     const Point2D::Value& point3) {
+    // Get vectors from point1 to point2 and from point1 to point3.
+    float direction_x = point2.x - point1.x;
+    float direction_y = point2.y - point1.y;
+    float direction_length = std::sqrt(direction_x * direction_x +
+                                       direction_y * direction_y);
+
+    float query_x = point3.x - point1.x;
+    float query_y = point3.y - point1.y;
+    float query_length_sq = query_x * query_x + query_y * query_y;
+
+    // Degenerate segment.
+    if (direction_length <= 0.0)
+      return std::sqrt(query_length_sq);
+
+    direction_x /= direction_length;
+    direction_y /= direction_length;
+
+    // Test if point projects onto line segment.
+    float dot_product = direction_x * query_x + direction_y * query_y;
+    if (dot_product <= direction_length && dot_product >= 0.0) {
+      // Projects onto line segment.
+      return std::sqrt(std::max(0.0f, query_length_sq -
+                                dot_product * dot_product));
+    }
+
+    // Doesn't project onto the line segment.
+    return std::min(DistancePointToPoint(point1, point3),
+                    DistancePointToPoint(point2, point3));
+  }
+
+  // Distance between two points.
+  float Point2D::DistancePointToPoint(const Point2D::Value& point1,
+                                      const Point2D::Value& point2) {
+    float dx = point2.x - point1.x;
+    float dy = point2.y - point1.y;
+    return std::sqrt(dx * dx + dy * dy);
+  }
+
+  // Take a step toward point2 from point1.
+  Point2D::Value Point2D::StepToward(const Point2D::Value& point1,
+                                     const Point2D::Value& point2,
+                                     float step_size) {
+    float length = DistancePointToPoint(point1, point2);
+    if (step_size >= length)
+      return point2;
+
+    float scale = step_size / length;
+    return Point2D::Value(point1.x + scale * (point2.x - point1.x),
+                          point1.y + scale * (point2.y - point1.y));
+  }
+
+  // Add two points with a scale factor.
+  Point2D::Value Point2D::Add(const Point2D::Value& point1,
+                              const Point2D::Value& point2,
+                              float scale) {
+    return Point2D::Value(point1.x + scale * point2.x,
+                          point1.y + scale * point2.y);
+  }
+
 } //\ namespace path
 
 #endif
@@ -36,7 +36,9 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-// This class defines an N-ary tree of Points.
+// This class defines an N-ary tree of Points. Nodes are stored in a flat
+// arena and linked by index, so the tree costs a few words per node and is
+// torn down in one deallocation.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -47,11 +49,10 @@
 #include <geometry/point_2d.h>
 #include <geometry/node_2d.h>
 #include <util/disallow_copy_and_assign.h>
-#include <flann/flann_point_2dtree.h>
+#include <geometry/kdtree_2d.h>
 
 #include <memory>
 #include <vector>
-#include <unordered_map>
 
 namespace path {
 
@@ -65,22 +66,69 @@ namespace path {
     bool Insert(Point2D::Ptr point);
     bool Insert(Point2D::Ptr point, Point2D::Ptr parent);
 
+    // Insert a point, either at the nearest node or at the specified parent.
+    // Returns the index of the new node, or Node2D::kNone on failure.
+    Node2D::Index Insert(const Point2D::Value& point);
+    Node2D::Index Insert(const Point2D::Value& point, Node2D::Index parent);
+
+    // Insert nodes every 'step_size' along the straight line from 'index'
+    // to 'target', then 'target' itself. Returns the index of 'target', or
+    // Node2D::kNone if a point could not be inserted. Does no collision
+    // checking.
+    Node2D::Index InsertSegment(Node2D::Index index,
+                                const Point2D::Value& target,
+                                float step_size);
+
     // Does the tree contain this point?
     bool Contains(Point2D::Ptr point) const;
+    bool Contains(const Point2D::Value& point) const;
+
+    // Index of the node at this point, or Node2D::kNone.
+    Node2D::Index Find(const Point2D::Value& point) const;
 
     // Tree size.
     int Size() const;
 
     // Get nearest point in the tree.
     Point2D::Ptr GetNearest(Point2D::Ptr point);
+    Point2D::Ptr GetNearest(const Point2D::Value& point);
+    Node2D::Index GetNearestIndex(const Point2D::Value& point) const;
+
+    // Indices of all nodes within 'radius' of 'point'. Clears 'neighbors'
+    // first, so the buffer can be reused across calls.
+    void RadiusSearch(const Point2D::Value& point, float radius,
+                      std::vector<Node2D::Index>& neighbors) const;
+
+    // Move a node, with its whole subtree, under a new parent. The new
+    // parent must not lie in that subtree.
+    void SetParent(Node2D::Index index, Node2D::Index parent);
+
+    // Detach a node from its parent and hide it from every query. The node
+    // keeps its index and its children, and stays in the kd tree as a
+    // tombstone, so it can later be restored under any live parent.
+    void Remove(Node2D::Index index);
+    void Restore(Node2D::Index index, Node2D::Index parent);
+    bool IsRemoved(Node2D::Index index) const;
 
     // Get the path from the head to a particular goal point.
     Trajectory2D::Ptr GetTrajectory(Point2D::Ptr goal);
+    Trajectory2D::Ptr GetTrajectory(Node2D::Index goal) const;
+
+    // Node accessors. Indices are assigned in insertion order, starting
+    // with the head at 0.
+    const Node2D& GetNode(Node2D::Index index) const;
+    const Point2D::Value& GetPoint(Node2D::Index index) const;
 
   private:
-    Node2D::Ptr head_;
-    std::unordered_map<Point2D::Ptr, Node2D::Ptr> registry_;
-    FlannPoint2DTree kd_tree_;
+    std::vector<Node2D> nodes_;
+    KdTree2D kd_tree_;
+
+    // Append a node to the arena and the kd tree.
+    Node2D::Index AddNode(const Point2D::Value& point, Node2D::Index parent);
+
+    // Add a node to, or take it out of, its parent's list of children.
+    void Link(Node2D::Index index, Node2D::Index parent);
+    void Unlink(Node2D::Index index);
 
     DISALLOW_COPY_AND_ASSIGN(RRT2D);
   };
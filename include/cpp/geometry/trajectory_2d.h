@@ -49,7 +49,10 @@
 
 namespace path {
 
-  // A Trajectory is just an ordered list of points.
+  // A Trajectory is just an ordered list of points. Coordinates are stored
+  // as two contiguous float arrays (structure of arrays) so that whole-path
+  // operations stream through memory; the Point2D::Ptr accessors hand out
+  // copies.
   class Trajectory2D {
   public:
     typedef std::shared_ptr<Trajectory2D> Ptr;
@@ -60,37 +63,60 @@ namespace path {
     static Ptr Create();
     static Ptr Create(std::vector<Point2D::Ptr>& points);
     static Ptr Create(std::list<Point2D::Ptr>& points);
+    static Ptr Create(const std::vector<Point2D::Value>& points);
+    static Ptr Create(const std::vector<float>& x,
+                      const std::vector<float>& y);
 
     // Recompute length.
     void RecomputeLength();
 
     // Add a point to the path.
     void AddPoint(Point2D::Ptr point);
+    void AddPoint(const Point2D::Value& point);
 
     // Upsample by adding k points linearly between each pair of points
     // in this Trajectory2D.
     void Upsample(unsigned int k);
 
     // Compute the (time) derivative of the path, assuming uniform sampling.
-    // Calculate at the endpoints by implicit padding.
-    Trajectory2D::Ptr TimeDerivative();
+    // Calculate at the endpoints by implicit padding. The second version
+    // writes into an existing trajectory, reusing its storage.
+    Trajectory2D::Ptr TimeDerivative() const;
+    void TimeDerivative(Trajectory2D& derivative) const;
+
+    // Time derivative of a single coordinate array. 'in' and 'out' must
+    // both hold 'count' elements and must not alias.
+    static void TimeDerivative(const float* in, size_t count, float* out);
 
     // Getters.
     double GetLength() const;
-    std::vector<Point2D::Ptr>& GetPoints();
-    Point2D::Ptr GetAt(size_t index);
+    size_t Size() const;
+    std::vector<Point2D::Ptr> GetPoints() const;
+    Point2D::Ptr GetAt(size_t index) const;
+    Point2D::Value GetValueAt(size_t index) const;
+
+    // Contiguous views of the coordinates, each Size() elements long.
+    // Call RecomputeLength() after writing through the mutable views.
+    const float* GetX() const;
+    const float* GetY() const;
+    float* GetMutableX();
+    float* GetMutableY();
 
     // Setter.
     void SetAt(Point2D::Ptr point, size_t index);
+    void SetAt(const Point2D::Value& point, size_t index);
 
   private:
-    std::vector<Point2D::Ptr> points_;
+    std::vector<float> x_;
+    std::vector<float> y_;
     double length_;
 
     // Private constructors. Use factory methods instead.
     Trajectory2D();
     Trajectory2D(std::vector<Point2D::Ptr>& points);
     Trajectory2D(std::list<Point2D::Ptr>& points);
+    Trajectory2D(const std::vector<Point2D::Value>& points);
+    Trajectory2D(const std::vector<float>& x, const std::vector<float>& y);
   };
 
 } //\ namespace path
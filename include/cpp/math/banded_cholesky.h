@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cholesky factorization of a symmetric positive definite band matrix.
+// Only the diagonal and the 'bandwidth' sub-diagonals are stored, so
+// factoring takes O(n k^2) time and each solve O(n k) for n rows and
+// bandwidth k.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_MATH_BANDED_CHOLESKY_H
+#define PATH_MATH_BANDED_CHOLESKY_H
+
+#include <cstddef>
+#include <vector>
+
+#include <util/disallow_copy_and_assign.h>
+
+namespace path {
+namespace math {
+
+class BandedCholesky {
+ public:
+  // Creates a zero matrix with 'size' rows and 'bandwidth' sub-diagonals.
+  BandedCholesky(size_t size, size_t bandwidth);
+
+  // Sets the entry at ('row', 'col'), and by symmetry ('col', 'row').
+  // Requires |row - col| <= bandwidth.
+  void Set(size_t row, size_t col, double value);
+
+  // Replaces the matrix with its lower triangular factor L, with A = L L'.
+  // Returns false if the matrix is not positive definite.
+  bool Factorize();
+
+  // Solves A x = b in place, overwriting 'b' (of length Size()) with x.
+  // Requires a successful call to Factorize().
+  void Solve(double* b) const;
+
+  size_t Size() const { return size_; }
+  size_t Bandwidth() const { return bandwidth_; }
+
+ private:
+  // Entry ('row', 'col') of the lower band, for col <= row.
+  double& At(size_t row, size_t col) {
+    return band_[row * (bandwidth_ + 1) + bandwidth_ + col - row];
+  }
+  double At(size_t row, size_t col) const {
+    return band_[row * (bandwidth_ + 1) + bandwidth_ + col - row];
+  }
+
+  const size_t size_;
+  const size_t bandwidth_;
+  std::vector<double> band_;
+  bool factorized_;
+
+  DISALLOW_COPY_AND_ASSIGN(BandedCholesky)
+
+};  //\class BandedCholesky
+
+}  //\namespace math
+}  //\namespace path
+
+#endif
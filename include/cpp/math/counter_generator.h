@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Counter-based pseudorandom numbers from Philox4x32-10 (Salmon et al.,
+// "Parallel Random Numbers: As Easy as 1, 2, 3"):
+// + http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+//
+// Sample 'index' of stream 'stream' is a pure function of (seed, stream,
+// index), so there is no state to share, and work split across any number
+// of threads draws exactly the same numbers as a serial run.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_MATH_COUNTER_GENERATOR_H
+#define PATH_MATH_COUNTER_GENERATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+namespace math {
+
+class CounterGenerator {
+ public:
+  explicit CounterGenerator(uint64_t seed = 0) : seed_(seed) {}
+
+  // Seed, which is the Philox key.
+  uint64_t GetSeed() const { return seed_; }
+  void SetSeed(uint64_t seed) { seed_ = seed; }
+
+  // Philox4x32-10 of a raw 128-bit counter under a 64-bit key.
+  static void Philox(const uint32_t counter[4], const uint32_t key[2],
+                     uint32_t block[4]);
+
+  // 128 random bits for sample ('stream', 'index').
+  void Block(uint64_t stream, uint64_t index, uint32_t block[4]) const;
+
+  // Two independent doubles in [0, 1) for sample ('stream', 'index').
+  void DoublePair(uint64_t stream, uint64_t index,
+                  double* first, double* second) const;
+
+  // A double in [0, 1) for sample ('stream', 'index').
+  double Double(uint64_t stream, uint64_t index) const;
+
+  // A double in ['min', 'max') for sample ('stream', 'index').
+  double DoubleUniform(uint64_t stream, uint64_t index,
+                       double min, double max) const;
+
+  // Appends samples 'first_index' through 'first_index' + 'count' - 1 of
+  // 'stream', each as from DoubleUniform().
+  void DoublesUniform(uint64_t stream, uint64_t first_index, size_t count,
+                      double min, double max,
+                      std::vector<double>* doubles) const;
+
+ private:
+  uint64_t seed_;
+
+};  //\class CounterGenerator
+
+}  //\namespace math
+}  //\namespace path
+
+#endif
@@ -35,11 +35,25 @@
  *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
  */
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// Pseudorandom numbers from xoshiro256** (Blackman and Vigna):
+// + http://prng.di.unimi.it/
+//
+// Each generator owns its state, so generators never affect each other and
+// need no locking. A single generator must not be shared between threads;
+// instead give each thread its own stream of a common seed, which keeps
+// parallel runs reproducible. Bulk functions draw from eight interleaved
+// lanes, updated with AVX2 when the library is built with it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
 #ifndef PATH_MATH_RANDOM_GENERATOR_H
 #define PATH_MATH_RANDOM_GENERATOR_H
 
 #include <glog/logging.h>
 #include <math.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <vector>
@@ -55,22 +69,32 @@ class RandomGenerator {
   RandomGenerator(unsigned long seed);
   RandomGenerator();
 
+  // Stream 'stream' of the sequence started by 'seed'. Streams of one seed
+  // are 2^128 draws apart, so they never overlap in practice.
+  RandomGenerator(unsigned long seed, unsigned long stream);
+
   // Creates a damn good seed.
   static unsigned long Seed();
 
+  // Advances the state by 2^128 draws.
+  void Jump();
+
+  // Generates 64 random bits.
+  uint64_t Next() const;
+
   // Generates a random integer in [0, RAND_MAX).
   int Integer() const;
 
-  // Generates a random integer in [0, 'max').
+  // Generates a random integer in [0, 'max'].
   int IntegerUniform(int max) const;
 
-  // Generates a random integer in ['min', 'max').
+  // Generates a random integer in ['min', 'max'].
   int IntegerUniform(int min, int max) const;
 
   // Generates 'count' random integers in [0, RAND_MAX).
   void Integers(size_t count, std::vector<int> *integers) const;
 
-  // Generates 'count' random integers between ['min', 'max').
+  // Generates 'count' random integers between ['min', 'max'].
   void IntegersUniform(size_t count, int min, int max,
                        std::vector<int> *integers) const;
 
@@ -97,6 +121,28 @@ class RandomGenerator {
                        std::vector<double>* doubles) const;
 
  private:
+  // Number of interleaved lanes used by the bulk functions.
+  static const size_t kLanes = 8;
+
+  // Bulk functions generate raw bits in blocks of this many.
+  static const size_t kBlockSize = 256;
+
+  // Sets the state from a seed, and seeds the lanes from the state.
+  void SetSeed(unsigned long seed);
+  void SeedLanes();
+
+  // Fills 'values' with 'count' random 64-bit integers from the lanes.
+  void NextLanes(size_t count, uint64_t* values) const;
+
+  // Random integer in [0, 'range') from 64 random bits.
+  static uint32_t Bounded(uint64_t bits, uint64_t range);
+
+  // Random double in [0, 1) from 64 random bits.
+  static double ToDouble(uint64_t bits);
+
+  mutable uint64_t state_[4];
+  mutable uint64_t lanes_[4][kLanes];
+
   DISALLOW_COPY_AND_ASSIGN(RandomGenerator)
 
 };  //\class RandomGenerator
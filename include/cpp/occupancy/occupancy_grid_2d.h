@@ -72,8 +72,21 @@ namespace path {
     int GetNCols() const { return ncols_ ; }
     int GetTotalCount() const { return count_; }
 
-    // Operations on the grid.
-    void Insert(Point2D::Ptr point);
+    // Raw counts, indexed (row, column). Row 0 is the top of the map, i.e.
+    // the largest y.
+    const MatrixXi& GetGrid() const { return grid_; }
+
+    // Row and column of the cell containing a point. Returns false if the
+    // point is out of bounds.
+    bool GetCell(const Point2D::Value& point, int& row, int& col) const;
+
+    // Center of the cell at (row, column).
+    Point2D::Value GetCellCenter(int row, int col) const;
+
+    // Operations on the grid. Insert() returns the obstacle it added to the
+    // scene, or null if the bin was already occupied, e.g. to pass to
+    // IncrementalRRTPlanner2D::Invalidate().
+    Obstacle2D::Ptr Insert(Point2D::Ptr point);
     int GetCountAt(Point2D::Ptr point) const;
     Point2D::Ptr GetBinCenter(Point2D::Ptr point) const;
 
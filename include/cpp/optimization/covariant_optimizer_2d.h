@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class smooths a trajectory through a Scene2DContinuous by covariant
+// gradient descent, as in CHOMP:
+// + https://www.ri.cmu.edu/pub_files/2009/5/icra09-chomp.pdf
+//
+// It minimizes the same objective as TrajectoryOptimizer2D,
+//
+//   sum_i w_c * cost(p_i) + 0.5 * w_s * |p_i+1 - p_i|^2,
+//
+// but preconditions each gradient step with the inverse of the finite
+// difference smoothness matrix A = K' K, which is tridiagonal. A step then
+// moves the whole path smoothly instead of single waypoints, and the
+// smoothness term alone is minimized in one step of size 1. The Cholesky
+// factor of A depends only on the number of waypoints, so each optimizer
+// keeps the one for the last length it saw.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_COVARIANT_OPTIMIZER_2D_H
+#define PATH_PLANNING_COVARIANT_OPTIMIZER_2D_H
+
+#include <geometry/point_2d.h>
+#include <geometry/trajectory_2d.h>
+#include <math/banded_cholesky.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <memory>
+#include <mutex>
+
+namespace path {
+
+  class CovariantOptimizer2D {
+  public:
+    CovariantOptimizer2D(const Scene2DContinuous& scene,
+                         float cost_weight, float smoothness_weight,
+                         float step_size = 0.5,
+                         float max_point_displacement = 1e-2)
+      : scene_(scene),
+        cost_weight_(cost_weight),
+        smoothness_weight_(smoothness_weight),
+        step_size_(step_size),
+        max_point_displacement_(max_point_displacement) {}
+    ~CovariantOptimizer2D() {}
+
+    // Optimize the given trajectory. Each step is scaled down as a whole so
+    // that no waypoint moves more than 'max_point_displacement', and steps
+    // that would increase the objective are retried at half the size of the
+    // step actually taken, growing back by a factor of two after each
+    // accepted step. Stops after
+    // 'max_iters' steps, or once waypoints move less than
+    // 'min_avg_displacement' on average.
+    Trajectory2D::Ptr Optimize(Trajectory2D::Ptr path,
+                               size_t max_iters = 50,
+                               float min_avg_displacement = 1e-4) const;
+
+  private:
+    // Cholesky factor of the smoothness matrix over 'size' free waypoints.
+    std::shared_ptr<const math::BandedCholesky>
+    GetSmoothnessFactor(size_t size) const;
+
+    const Scene2DContinuous& scene_;
+    const float cost_weight_;
+    const float smoothness_weight_;
+    const float step_size_;
+    const float max_point_displacement_;
+
+    // Factor for the last trajectory length.
+    mutable std::mutex factor_mutex_;
+    mutable std::shared_ptr<const math::BandedCholesky> factor_;
+
+    DISALLOW_COPY_AND_ASSIGN(CovariantOptimizer2D);
+  };
+
+} //\ namespace path
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class optimizes a trajectory coarse to fine. The input path is
+// optimized as is, then upsampled with Trajectory2D::Upsample() and refined,
+// level after level, with each level warm started from the one before.
+// Each level runs CovariantOptimizer2D until waypoints move less than the
+// displacement threshold, so most iterations run on the small, coarse
+// problems and the fine levels only polish.
+//
+// Weights are given for the finest level. A coarser level with 1/s as many
+// segments scales the cost weight by s and the smoothness weight by 1/s, so
+// that every level discretizes the same continuous objective. Each level
+// has its own CovariantOptimizer2D, kept across calls, so paths of the same
+// length reuse every level's smoothness factor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_MULTI_RESOLUTION_OPTIMIZER_2D_H
+#define PATH_PLANNING_MULTI_RESOLUTION_OPTIMIZER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <optimization/covariant_optimizer_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <memory>
+#include <vector>
+
+namespace path {
+
+  class MultiResolutionOptimizer2D {
+  public:
+    // Each of the 'num_levels' - 1 refinements inserts 'upsample' points
+    // between each pair of waypoints. 'step_size' and
+    // 'max_point_displacement' are passed on to CovariantOptimizer2D.
+    MultiResolutionOptimizer2D(const Scene2DContinuous& scene,
+                               float cost_weight, float smoothness_weight,
+                               unsigned int num_levels = 3,
+                               unsigned int upsample = 3,
+                               float step_size = 0.5,
+                               float max_point_displacement = 1e-2);
+    ~MultiResolutionOptimizer2D() {}
+
+    // Optimize the given trajectory, returning one at the finest level.
+    // Each level stops after 'max_iters' iterations, or once waypoints move
+    // less than 'min_avg_displacement' on average.
+    Trajectory2D::Ptr Optimize(Trajectory2D::Ptr path,
+                               size_t max_iters = 50,
+                               float min_avg_displacement = 1e-4) const;
+
+  private:
+    const unsigned int num_levels_;
+    const unsigned int upsample_;
+
+    // One optimizer per level, coarsest first.
+    std::vector<std::unique_ptr<CovariantOptimizer2D> > optimizers_;
+
+    DISALLOW_COPY_AND_ASSIGN(MultiResolutionOptimizer2D);
+  };
+
+} //\ namespace path
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class smooths a trajectory through a Scene2DContinuous by solving a
+// sparse nonlinear least-squares problem with Ceres. Each interior waypoint
+// contributes an obstacle residual sqrt(2 * w_c * cost(p_i)), and each pair
+// of consecutive waypoints a smoothness residual sqrt(w_s) * (p_i+1 - p_i),
+// so the objective is
+//
+//   sum_i w_c * cost(p_i) + 0.5 * w_s * |p_i+1 - p_i|^2.
+//
+// Endpoints are held fixed. Both residuals have analytic Jacobians, and
+// the normal equations are banded (each waypoint only couples to its
+// neighbors), so they are factored with sparse Cholesky.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_TRAJECTORY_OPTIMIZER_2D_H
+#define PATH_PLANNING_TRAJECTORY_OPTIMIZER_2D_H
+
+#include <geometry/point_2d.h>
+#include <geometry/trajectory_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+namespace path {
+
+  class TrajectoryOptimizer2D {
+  public:
+    TrajectoryOptimizer2D(const Scene2DContinuous& scene,
+                          float cost_weight, float smoothness_weight)
+      : scene_(scene),
+        cost_weight_(cost_weight),
+        smoothness_weight_(smoothness_weight) {}
+    ~TrajectoryOptimizer2D() {}
+
+    // Optimize the given trajectory. Stops after 'max_iters' solver
+    // iterations, or once a step changes the waypoints by less than
+    // 'tolerance' relative to their magnitude. With 'parallel' set, the
+    // residuals of all waypoints are evaluated concurrently on every
+    // hardware thread. Partial sums are then combined in no fixed order, so
+    // the result may differ from a serial run by rounding.
+    Trajectory2D::Ptr Optimize(Trajectory2D::Ptr path,
+                               size_t max_iters = 100,
+                               float tolerance = 1e-4,
+                               bool parallel = false) const;
+
+  private:
+    const Scene2DContinuous& scene_;
+    const float cost_weight_;
+    const float smoothness_weight_;
+
+    DISALLOW_COPY_AND_ASSIGN(TrajectoryOptimizer2D);
+  };
+
+} //\ namespace path
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines an A* planner that searches the cells of an
+// OccupancyGrid2D directly, with 8-connected moves and the octile distance
+// heuristic, which is exact on an empty grid:
+// + http://theory.stanford.edu/~amitp/GameProgramming/Heuristics.html
+//
+// A cell is blocked if a circular robot centered in it would overlap the
+// obstacle of an occupied cell, i.e. occupied cells are inflated by the
+// robot radius. Diagonal moves may not cut the corner of a blocked cell.
+// All per-cell state lives in flat arrays that are allocated once and
+// reused, so a query touches only the cells it reaches: values, and
+// whether a cell is closed, are tagged with the query that wrote them
+// instead of being cleared.
+//
+// Optionally, the search runs as Jump Point Search, which expands only the
+// cells where an optimal path may turn and returns paths of the same cost:
+// + http://users.cecs.anu.edu.au/~dharabor/data/papers/harabor-grastien-aaai11.pdf
+// The jump distances in each of the 8 directions are precomputed, as in
+// JPS+, so jumping is a table lookup. Diagonal moves may not cut corners,
+// which leaves only straight moves with forced neighbors:
+// + http://users.cecs.anu.edu.au/~dharabor/data/papers/harabor-grastien-icaps14.pdf
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_GRID_ASTAR_PLANNER_2D_H
+#define PATH_PLANNING_GRID_ASTAR_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <occupancy/occupancy_grid_2d.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class GridAStarPlanner2D {
+  public:
+    GridAStarPlanner2D(const OccupancyGrid2D& grid, float robot_radius);
+    ~GridAStarPlanner2D() {}
+
+    // Recompute the blocked cells. Call after inserting points into the
+    // grid.
+    void Inflate();
+
+    // Find a shortest 8-connected path between the cells containing
+    // 'origin' and 'goal'. 'path' runs from 'origin' through the centers of
+    // the cells in between to 'goal'. Returns INVALID_ARGUMENT if either
+    // point is off the grid, FAILED_PRECONDITION if either cell is blocked,
+    // and NOT_FOUND if no path exists.
+    Status PlanTrajectory(const Point2D::Value& origin,
+                          const Point2D::Value& goal,
+                          Trajectory2D::Ptr& path);
+
+    // Length of the last path found, measured between cell centers.
+    float GetCost() const;
+
+    // Is this cell blocked?
+    bool IsBlocked(int row, int col) const;
+
+    // Search with Jump Point Search instead of expanding every cell. The
+    // jump tables are built on the first such query after each Inflate().
+    void SetJumpPointSearch(bool enabled);
+
+    // Number of cells expanded by the last query.
+    size_t GetNumExpanded() const { return num_expanded_; }
+
+  private:
+    // An entry of the open list.
+    struct Entry {
+      float f;
+      int cell;
+    };
+
+    // Indexed binary min-heap on f. Each cell's position in the heap is
+    // kept in heap_position_, so its key can be decreased in place.
+    void Push(int cell, float f);
+    int Pop();
+    void SiftUp(size_t position);
+    void SiftDown(size_t position);
+    bool Less(const Entry& a, const Entry& b) const;
+
+    // Reach 'next' from 'cell' at cost 'step', moving in 'direction'.
+    void Relax(int cell, int next, float step, uint8_t direction,
+               int goal_row, int goal_col);
+
+    // Push every neighbor of 'cell'.
+    void ExpandNeighbors(int cell, int goal_row, int goal_col);
+
+    // Push the jump point successors of 'cell'.
+    void ExpandJumpPoints(int cell, int goal_row, int goal_col);
+
+    // Fill jump_. Entry 8 * cell + direction is the number of steps from
+    // 'cell' to the next jump point in that direction if positive, and
+    // minus the number of free steps before a blocked cell otherwise.
+    void BuildJumpTables();
+
+    const OccupancyGrid2D& grid_;
+    const float robot_radius_;
+    const int nrows_;
+    const int ncols_;
+
+    // Cells are numbered row * ncols + col.
+    std::vector<uint8_t> blocked_;
+
+    bool jump_point_search_;
+    bool jump_tables_valid_;
+    std::vector<int16_t> jump_;
+
+    // Per-cell search state. g_, parent_, direction_ and heap_position_
+    // are valid only where query_ is the current query number (open) or
+    // one more (closed). Query numbers are even.
+    std::vector<uint32_t> query_;
+    std::vector<float> g_;
+    std::vector<int> parent_;
+    std::vector<uint8_t> direction_;
+    std::vector<int> heap_position_;
+    uint32_t current_query_;
+    float cost_;
+    size_t num_expanded_;
+
+    std::vector<Entry> heap_;
+
+    DISALLOW_COPY_AND_ASSIGN(GridAStarPlanner2D);
+  };
+
+} //\ namespace path
+
+#endif
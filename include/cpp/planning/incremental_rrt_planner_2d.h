@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines an RRT planner that keeps its tree when obstacles are
+// added to the scene, in the spirit of dynamic RRT and RRTX:
+// + Ferguson, Kalra and Stentz, "Replanning with RRTs", ICRA 2006
+// + Otte and Frazzoli, "RRTX: Asymptotically optimal single-query
+//   sampling-based motion planning with quick replanning", IJRR 2016
+//
+// After obstacles are added within some region, Invalidate() rechecks only
+// the edges that can reach that region. Every node below a blocked edge is
+// orphaned and hidden from the tree's spatial index. The orphans are then
+// reconnected in breadth-first order. A node whose own edge is intact
+// rejoins under its old parent, if that parent is back. Any other node
+// joins the nearest live node it can see within one step. Orphans that
+// cannot reconnect stay behind as tombstones. The rest of the tree, and
+// its kd tree, are untouched. The next call to PlanTrajectory() grows the
+// repaired tree toward the goal.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_INCREMENTAL_RRT_PLANNER_2D_H
+#define PATH_PLANNING_INCREMENTAL_RRT_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <geometry/rrt_2d.h>
+#include <planning/sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
+#include <robot/robot_2d_circular.h>
+#include <scene/obstacle_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class IncrementalRRTPlanner2D {
+  public:
+    IncrementalRRTPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
+                            Point2D::Ptr origin, Point2D::Ptr goal,
+                            float step_size = 0.1,
+                            size_t max_samples = 100000)
+      : robot_(robot), scene_(scene),
+        origin_(origin), goal_(goal),
+        sampler_(UniformSampler2D::Create(scene)),
+        goal_index_(Node2D::kNone),
+        num_samples_(0),
+        step_size_(step_size),
+        max_samples_(max_samples) {}
+    ~IncrementalRRTPlanner2D() {}
+
+    // The algorithm. See header for references. Same contract as
+    // RRTPlanner2D::PlanTrajectory(), except that FAILED_PRECONDITION (with
+    // a null path) means that an obstacle now covers the origin.
+    Status PlanTrajectory(const util::Deadline& deadline,
+                          const util::CancellationToken::Ptr& cancel,
+                          Trajectory2D::Ptr& path);
+
+    // Same, with no deadline and no way to cancel.
+    Trajectory2D::Ptr PlanTrajectory();
+
+    // Repair the tree after obstacles have been added to the scene within
+    // 'radius' of 'center'. Returns the number of nodes that could not be
+    // reconnected.
+    size_t Invalidate(const Point2D::Value& center, float radius);
+    size_t Invalidate(const Obstacle2D& obstacle);
+
+    // Set the sampler. Defaults to a UniformSampler2D over the scene.
+    void SetSampler(Sampler2D::Ptr sampler);
+
+    // The tree, including tombstones (see RRT2D::IsRemoved()).
+    const RRT2D& GetTree() const { return tree_; }
+
+  private:
+    // A node detached by Invalidate(), with the parent it had, and whether
+    // the edge to that parent is now blocked.
+    struct Orphan {
+      Node2D::Index index;
+      Node2D::Index parent;
+      bool blocked;
+    };
+
+    Robot2DCircular& robot_;
+    Scene2DContinuous& scene_;
+    Point2D::Ptr origin_;
+    Point2D::Ptr goal_;
+    Sampler2D::Ptr sampler_;
+
+    // Every edge in the tree is at most 'step_size' long, which bounds the
+    // region Invalidate() has to search.
+    RRT2D tree_;
+    Node2D::Index goal_index_;
+    uint64_t num_samples_;
+    const float step_size_;
+    const size_t max_samples_;
+
+    // Scratch space reused across calls to Invalidate().
+    std::vector<Node2D::Index> neighbors_;
+    std::vector<Node2D::Index> blocked_;
+    std::vector<Orphan> orphans_;
+
+    DISALLOW_COPY_AND_ASSIGN(IncrementalRRTPlanner2D)
+  };
+
+} //\ namespace path
+
+#endif
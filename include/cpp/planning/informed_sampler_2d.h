@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class implements informed sampling for RRT*:
+// + http://arxiv.org/abs/1404.2334
+//
+// Once a path of length c from origin to goal is known, only points p with
+// |p - origin| + |p - goal| < c can shorten it. Those points fill an
+// ellipse with foci at origin and goal, and this sampler draws uniformly
+// from the part of it inside the scene bounds. Until a path is known it
+// samples the scene uniformly, as UniformSampler2D does.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_INFORMED_SAMPLER_2D_H
+#define PATH_PLANNING_INFORMED_SAMPLER_2D_H
+
+#include <planning/sampler_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/disallow_copy_and_assign.h>
+
+namespace path {
+
+  class InformedSampler2D : public Sampler2D {
+  public:
+    typedef std::shared_ptr<InformedSampler2D> Ptr;
+
+    // Factory method.
+    static InformedSampler2D::Ptr Create(const Scene2DContinuous& scene,
+                                         const Point2D::Value& origin,
+                                         const Point2D::Value& goal);
+
+    ~InformedSampler2D() {}
+
+    // Sample 'index' of stream 'stream'.
+    Point2D::Value Sample(uint64_t stream, uint64_t index,
+                          float best_cost) const override;
+
+  private:
+    InformedSampler2D(const Scene2DContinuous& scene,
+                      const Point2D::Value& origin,
+                      const Point2D::Value& goal);
+
+    // Ellipse draws that land outside the scene bounds are redrawn this many
+    // times before switching to rejection within the ellipse's bounding box
+    // clipped to the scene bounds.
+    static const int kMaxAttempts = 16;
+
+    const Scene2DContinuous& scene_;
+
+    // Center of the ellipse, distance between the foci, and unit vector
+    // from origin to goal.
+    Point2D::Value center_;
+    float focal_distance_;
+    float cos_;
+    float sin_;
+
+    DISALLOW_COPY_AND_ASSIGN(InformedSampler2D);
+  };
+
+} //\ namespace path
+
+#endif
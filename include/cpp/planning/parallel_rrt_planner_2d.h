@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines a parallel version of RRTPlanner2D. The tree grows in
+// rounds. In each round a batch of samples is drawn, and every sample's
+// nearest node, step and collision checks are computed concurrently
+// against the tree as it stood at the start of the round. The accepted
+// steps are then inserted serially, in sample order. Reads and writes
+// never overlap, so the tree and its kd tree need no locking, and the
+// result does not depend on the number of threads.
+//
+// Threads come from OpenMP, when the library is built with it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_PARALLEL_RRT_PLANNER_2D_H
+#define PATH_PLANNING_PARALLEL_RRT_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <geometry/rrt_2d.h>
+#include <planning/sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
+#include <robot/robot_2d_circular.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class ParallelRRTPlanner2D {
+  public:
+    ParallelRRTPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
+                         Point2D::Ptr origin, Point2D::Ptr goal,
+                         float step_size = 0.1, size_t max_samples = 100000,
+                         size_t batch_size = 256)
+      : robot_(robot), scene_(scene),
+        origin_(origin), goal_(goal),
+        sampler_(UniformSampler2D::Create(scene)),
+        num_samples_(0),
+        step_size_(step_size),
+        max_samples_(max_samples),
+        batch_size_(batch_size) {}
+    ~ParallelRRTPlanner2D() {}
+
+    // The algorithm. See header for references. Same contract as
+    // RRTPlanner2D::PlanTrajectory(); the deadline and the token are
+    // checked between rounds.
+    Status PlanTrajectory(const util::Deadline& deadline,
+                          const util::CancellationToken::Ptr& cancel,
+                          Trajectory2D::Ptr& path);
+
+    // Same, with no deadline and no way to cancel.
+    Trajectory2D::Ptr PlanTrajectory();
+
+    // Set the sampler. It is called from several threads at once.
+    void SetSampler(Sampler2D::Ptr sampler);
+
+  private:
+    // Work for one sample of a round. 'parent' is Node2D::kNone if the step
+    // is blocked.
+    struct Step {
+      Point2D::Value point;
+      Node2D::Index parent;
+      bool sees_goal;
+    };
+
+    Robot2DCircular& robot_;
+    Scene2DContinuous& scene_;
+    Point2D::Ptr origin_;
+    Point2D::Ptr goal_;
+    Sampler2D::Ptr sampler_;
+
+    RRT2D tree_;
+    uint64_t num_samples_;
+    const float step_size_;
+    const size_t max_samples_;
+    const size_t batch_size_;
+
+    // Scratch space reused across rounds.
+    std::vector<Step> steps_;
+
+    DISALLOW_COPY_AND_ASSIGN(ParallelRRTPlanner2D)
+  };
+
+} //\ namespace path
+
+#endif
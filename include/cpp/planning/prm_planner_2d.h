@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines a probabilistic roadmap (PRM) planner, for answering
+// many queries in the same static scene:
+// + http://www.kavrakilab.org/publications/kavraki-svestka1996probabilistic-roadmaps.pdf
+//
+// The roadmap is built once. Feasible samples are drawn and each is joined
+// to its nearest neighbors within a connection radius wherever the robot
+// has line of sight. Sampling and edge checks run concurrently with OpenMP
+// when the library is built with it, and the result does not depend on the
+// number of threads. Edges are stored in compressed sparse row (CSR) form:
+// the neighbors of node ii are targets_[offsets_[ii]] ..
+// targets_[offsets_[ii + 1] - 1].
+//
+// A query joins its endpoints to the roadmap and runs A* over it. Per-node
+// search state is tagged with the query that wrote it, so a query only
+// touches the nodes it reaches.
+//
+// In lazy mode, roadmap edges are not checked when the roadmap is built.
+// A query checks only the edges of the path it finds, drops the blocked
+// ones for good and searches again, as in Lazy PRM:
+// + http://www.kavrakilab.org/publications/bohlin-kavraki2000path-planning.pdf
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_PRM_PLANNER_2D_H
+#define PATH_PLANNING_PRM_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <geometry/kdtree_2d.h>
+#include <planning/sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
+#include <robot/robot_2d_circular.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class PRMPlanner2D {
+  public:
+    PRMPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
+                 size_t num_samples = 1000, float connection_radius = 0.1,
+                 size_t max_neighbors = 16)
+      : robot_(robot), scene_(scene),
+        sampler_(UniformSampler2D::Create(scene)),
+        num_samples_(num_samples),
+        connection_radius_(connection_radius),
+        max_neighbors_(max_neighbors),
+        lazy_(false),
+        built_(false),
+        current_query_(0),
+        cost_(0.0) {}
+    ~PRMPlanner2D() {}
+
+    // Build the roadmap. Queries build it if needed, so calling this is
+    // only necessary to control when the work is done, or to rebuild after
+    // the scene changes.
+    void BuildRoadmap();
+
+    // Find a path from 'origin' to 'goal' through the roadmap. Endpoints
+    // are joined to their nearest visible roadmap nodes, or directly to
+    // each other if they are in line of sight. Returns FAILED_PRECONDITION
+    // if either endpoint is infeasible and NOT_FOUND if no path exists.
+    // Queries share search state, so they may not run concurrently.
+    Status PlanTrajectory(const Point2D::Value& origin,
+                          const Point2D::Value& goal,
+                          Trajectory2D::Ptr& path);
+
+    // Length of the last path found.
+    float GetCost() const { return cost_; }
+
+    // Roadmap size. Each edge is counted once.
+    size_t GetNumNodes() const { return points_.size(); }
+    size_t GetNumEdges() const { return targets_.size() / 2; }
+
+    // Set the sampler. It is called from several threads at once. Takes
+    // effect at the next BuildRoadmap().
+    void SetSampler(Sampler2D::Ptr sampler);
+
+    // Defer roadmap edge checks to the queries that use them. Takes effect
+    // at the next BuildRoadmap(). Off by default.
+    void SetLazyCollisionChecking(bool lazy) { lazy_ = lazy; }
+
+  private:
+    // State of a roadmap edge.
+    typedef enum {
+      UNCHECKED = 0,
+      VALID = 1,
+      BLOCKED = 2,
+    } EdgeState;
+
+    // An entry of the open list. Entries are not removed when a node's
+    // cost drops; the stale ones are skipped instead.
+    struct Entry {
+      float f;
+      float g;
+      int node;
+
+      bool operator>(const Entry& other) const { return f > other.f; }
+    };
+
+    // Up to max_neighbors_ visible roadmap nodes within the connection
+    // radius of 'point', nearest first. Falls back to the nearest node if
+    // none is in range.
+    void Connect(const Point2D::Value& point, std::vector<int>& nodes);
+
+    // A* from the origin to the goal, which are joined to the nodes in
+    // origin_links_ and goal_links_. Returns whether the goal was reached.
+    bool Search(const Point2D::Value& origin, const Point2D::Value& goal);
+
+    // Check the unchecked roadmap edges of the path found by Search().
+    // Marks each one valid or blocked, and returns false if any is blocked.
+    bool ValidatePath();
+
+    // Index into targets_ of the edge from 'node' to 'other'.
+    int FindEdge(int node, int other) const;
+
+    Robot2DCircular& robot_;
+    Scene2DContinuous& scene_;
+    Sampler2D::Ptr sampler_;
+    const size_t num_samples_;
+    const float connection_radius_;
+    const size_t max_neighbors_;
+    bool lazy_;
+
+    // The roadmap.
+    bool built_;
+    std::vector<Point2D::Value> points_;
+    KdTree2D index_;
+    std::vector<int> offsets_;
+    std::vector<int> targets_;
+    std::vector<float> weights_;
+    std::vector<uint8_t> edge_states_;
+
+    // Per-node search state, with two extra nodes for the origin and the
+    // goal. g_ and parent_ are valid only where query_ equals the current
+    // query number, and goal_link_ marks the nodes joined to the goal.
+    std::vector<uint32_t> query_;
+    std::vector<uint32_t> goal_link_;
+    std::vector<float> g_;
+    std::vector<int> parent_;
+    uint32_t current_query_;
+    float cost_;
+
+    // Scratch space reused across queries.
+    std::vector<Entry> open_;
+    std::vector<int> origin_links_;
+    std::vector<int> goal_links_;
+
+    DISALLOW_COPY_AND_ASSIGN(PRMPlanner2D)
+  };
+
+} //\ namespace path
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines the RRT-Connect planner, which grows one tree from the
+// origin and one from the goal and greedily tries to join them:
+// + http://www.kuffner.org/james/papers/kuffner_icra2000.pdf
+//
+// Samples come from an indexed Sampler2D (by default, uniform over the
+// scene), so a plan depends only on the scene, the endpoints and the
+// sampler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_RRT_CONNECT_PLANNER_2D_H
+#define PATH_PLANNING_RRT_CONNECT_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <geometry/rrt_2d.h>
+#include <planning/sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
+#include <robot/robot_2d_circular.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+
+namespace path {
+
+  class RRTConnectPlanner2D {
+  public:
+    RRTConnectPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
+                        Point2D::Ptr origin, Point2D::Ptr goal,
+                        float step_size = 0.1, size_t max_samples = 10000)
+      : robot_(robot), scene_(scene),
+        origin_(origin), goal_(goal),
+        sampler_(UniformSampler2D::Create(scene)),
+        num_samples_(0),
+        step_size_(step_size),
+        max_samples_(max_samples) {}
+    ~RRTConnectPlanner2D() {}
+
+    // The algorithm. See header for references. Grows the trees until they
+    // meet, 'max_samples' samples have been drawn in this call, 'deadline'
+    // passes, or 'cancel' (which may be null) is set. 'path' is the joined
+    // path once the trees meet, and until then the path to the node of the
+    // origin tree nearest the goal. Returns OK if the trees met,
+    // DEADLINE_EXCEEDED or CANCELLED if stopped early, and NOT_FOUND if the
+    // samples ran out. Calling again keeps growing the same trees.
+    Status PlanTrajectory(const util::Deadline& deadline,
+                          const util::CancellationToken::Ptr& cancel,
+                          Trajectory2D::Ptr& path);
+
+    // Same, with no deadline and no way to cancel.
+    Trajectory2D::Ptr PlanTrajectory();
+
+    // Set the sampler. Defaults to a UniformSampler2D over the scene.
+    void SetSampler(Sampler2D::Ptr sampler);
+
+  private:
+    // Result of growing a tree toward a point.
+    typedef enum {
+      TRAPPED = 0,
+      ADVANCED = 1,
+      REACHED = 2,
+    } ExtendResult;
+
+    // Take one step from the nearest node of 'tree' toward 'target'. The
+    // new node, if any, is returned in 'index'.
+    ExtendResult Extend(RRT2D& tree, const Point2D::Value& target,
+                        Node2D::Index& index);
+
+    // Step toward 'target' until reaching it or getting trapped.
+    ExtendResult Connect(RRT2D& tree, const Point2D::Value& target,
+                         Node2D::Index& index);
+
+    Robot2DCircular& robot_;
+    Scene2DContinuous& scene_;
+    Point2D::Ptr origin_;
+    Point2D::Ptr goal_;
+    Sampler2D::Ptr sampler_;
+
+    RRT2D origin_tree_;
+    RRT2D goal_tree_;
+    Trajectory2D::Ptr path_;
+    uint64_t num_samples_;
+    const float step_size_;
+    const size_t max_samples_;
+
+    DISALLOW_COPY_AND_ASSIGN(RRTConnectPlanner2D)
+  };
+
+} //\ namespace path
+
+#endif
@@ -41,6 +41,11 @@
 // + https://www.cs.cmu.edu/~motionplanning/lecture/lec20.pdf
 // + http://msl.cs.uiuc.edu/rrt/about.html
 //
+// In lazy mode, edges are assumed to be collision-free while the tree
+// grows, and only the edges of a candidate path are checked, in the spirit
+// of Lazy PRM:
+// + http://www.kavrakilab.org/publications/bohlin-kavraki2000path-planning.pdf
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef PATH_PLANNING_RRT_PLANNER_2D_H
@@ -49,34 +54,88 @@
 #include <geometry/trajectory_2d.h>
 #include <geometry/point_2d.h>
 #include <geometry/rrt_2d.h>
+#include <planning/sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
 #include <robot/robot_2d_circular.h>
 #include <scene/scene_2d_continuous.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
 #include <util/types.h>
 #include <util/disallow_copy_and_assign.h>
 
+#include <stdint.h>
+#include <vector>
+
 namespace path {
 
   // Derived from base class Planner.
   class RRTPlanner2D {
   public:
     RRTPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
-                 Point2D::Ptr origin, Point2D::Ptr goal, float step_size = 0.1)
+                 Point2D::Ptr origin, Point2D::Ptr goal, float step_size = 0.1,
+                 size_t max_samples = 100000)
       : robot_(robot), scene_(scene),
         origin_(origin), goal_(goal),
-        step_size_(step_size) {}
+        sampler_(UniformSampler2D::Create(scene)),
+        lazy_(false),
+        num_samples_(0),
+        step_size_(step_size),
+        max_samples_(max_samples) {}
     ~RRTPlanner2D() {}
 
-    // The algorithm. See header for references.
+    // The algorithm. See header for references. Grows the tree until it
+    // reaches the goal, 'max_samples' samples have been drawn in this call,
+    // 'deadline' passes, or 'cancel' (which may be null) is set. 'path' is
+    // always the best trajectory so far: to the goal if it was reached, and
+    // otherwise to the node nearest the goal. Returns OK if the goal was
+    // reached, DEADLINE_EXCEEDED or CANCELLED if stopped early, and
+    // NOT_FOUND if the samples ran out. Calling again keeps growing the
+    // same tree.
+    Status PlanTrajectory(const util::Deadline& deadline,
+                          const util::CancellationToken::Ptr& cancel,
+                          Trajectory2D::Ptr& path);
+
+    // Same, with no deadline and no way to cancel.
     Trajectory2D::Ptr PlanTrajectory();
 
+    // Set the sampler. Defaults to a UniformSampler2D over the scene.
+    void SetSampler(Sampler2D::Ptr sampler);
+
+    // Defer collision checks. New nodes are still checked, but the edge to
+    // each is not checked until a path through it is about to be returned,
+    // and an edge found blocked is pruned along with everything below it.
+    // The goal is joined only from nodes within one step of it, rather than
+    // from any node that can see it. Off by default.
+    void SetLazyCollisionChecking(bool lazy) { lazy_ = lazy; }
+
   private:
+    // Insert a node, recording whether its edge has been checked.
+    Node2D::Index Insert(const Point2D::Value& point, Node2D::Index parent,
+                         bool checked);
+
+    // Check the unchecked edges on the path to 'index', from the root
+    // down. If one is blocked, the subtree below it is removed and the
+    // last node before it is returned; otherwise 'index' is returned.
+    Node2D::Index Validate(Node2D::Index index);
+
     Robot2DCircular& robot_;
     Scene2DContinuous& scene_;
     Point2D::Ptr origin_;
     Point2D::Ptr goal_;
+    Sampler2D::Ptr sampler_;
+    bool lazy_;
 
     RRT2D tree_;
+    uint64_t num_samples_;
     const float step_size_;
+    const size_t max_samples_;
+
+    // Whether each node's edge to its parent is known to be collision-free.
+    std::vector<uint8_t> checked_;
+
+    // Scratch space for Validate().
+    std::vector<Node2D::Index> path_;
 
     DISALLOW_COPY_AND_ASSIGN(RRTPlanner2D)
   };
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines the RRT* planner, which grows a single tree from the
+// origin, attaches each new node to the neighbor that gives it the cheapest
+// path, and rewires neighbors through the new node when that shortens
+// their paths:
+// + http://arxiv.org/abs/1105.1186
+//
+// Path cost is length. Each node's cost-to-come is stored, and a rewire
+// shifts the costs of the moved subtree by the same amount. Neighbors come
+// from one radius query per sample, capped at the 'max_neighbors' closest,
+// and each edge to a neighbor is collision checked at most once per
+// sample, and only if it could change the tree.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_RRT_STAR_PLANNER_2D_H
+#define PATH_PLANNING_RRT_STAR_PLANNER_2D_H
+
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <geometry/rrt_2d.h>
+#include <planning/sampler_2d.h>
+#include <robot/robot_2d_circular.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace path {
+
+  class RRTStarPlanner2D {
+  public:
+    // The neighbor radius shrinks as gamma * sqrt(log(n) / n) for a tree of
+    // n nodes, but never below the distance to the nearest node or above
+    // 'step_size'.
+    RRTStarPlanner2D(Robot2DCircular& robot, Scene2DContinuous& scene,
+                     Point2D::Ptr origin, Point2D::Ptr goal,
+                     float step_size = 0.1, size_t max_samples = 5000,
+                     float gamma = 1.5, size_t max_neighbors = 32);
+    ~RRTStarPlanner2D() {}
+
+    // The algorithm. See header for references. Draws 'max_samples'
+    // samples, so the path keeps improving after the goal is first reached,
+    // but stops early once 'deadline' passes or 'cancel' (which may be null)
+    // is set. 'path' is always the best trajectory so far: to the goal if it
+    // has been reached, and otherwise to the node nearest it. Returns OK if
+    // all samples were drawn and the goal has been reached, NOT_FOUND if
+    // they were drawn without reaching it, and DEADLINE_EXCEEDED or
+    // CANCELLED if stopped early; in those cases GetBestCost() tells
+    // whether 'path' reaches the goal. Calling again draws more samples
+    // into the same tree.
+    Status PlanTrajectory(const util::Deadline& deadline,
+                          const util::CancellationToken::Ptr& cancel,
+                          Trajectory2D::Ptr& path);
+
+    // Same, with no deadline and no way to cancel.
+    Trajectory2D::Ptr PlanTrajectory();
+
+    // Set the sampler. Defaults to a UniformSampler2D over the scene.
+    void SetSampler(Sampler2D::Ptr sampler);
+
+    // Length of the best path to the goal so far, or infinity.
+    float GetBestCost() const;
+
+    // Number of nodes in the tree.
+    int GetTreeSize() const;
+
+  private:
+    // A neighbor of the point being inserted. 'visible' is 1 or 0 once the
+    // edge has been collision checked, and -1 before.
+    struct Candidate {
+      Node2D::Index index;
+      float distance;
+      float cost;
+      int visible;
+    };
+
+    // Insert 'point' under its cheapest visible neighbor and rewire the
+    // rest. 'nearest' is the node nearest 'point'. Returns the new node, or
+    // Node2D::kNone if no neighbor can see 'point'.
+    Node2D::Index Insert(const Point2D::Value& point, Node2D::Index nearest);
+
+    // Move 'index' under 'parent' at cost 'cost', and update its subtree.
+    void Rewire(Node2D::Index index, Node2D::Index parent, float cost);
+
+    // Neighbor radius for the current tree size.
+    float NeighborRadius() const;
+
+    Robot2DCircular& robot_;
+    Scene2DContinuous& scene_;
+    Point2D::Ptr origin_;
+    Point2D::Ptr goal_;
+    Sampler2D::Ptr sampler_;
+
+    RRT2D tree_;
+    std::vector<float> cost_;
+    Node2D::Index goal_index_;
+    uint64_t num_samples_;
+
+    const float step_size_;
+    const size_t max_samples_;
+    const float gamma_;
+    const size_t max_neighbors_;
+
+    // Scratch space reused across insertions.
+    std::vector<Node2D::Index> neighbors_;
+    std::vector<Candidate> candidates_;
+    std::vector<Node2D::Index> stack_;
+
+    DISALLOW_COPY_AND_ASSIGN(RRTStarPlanner2D)
+  };
+
+} //\ namespace path
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class samples uniformly over the bounds of a Scene2DContinuous,
+// using the scene's indexed random points. It ignores the best path cost.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_UNIFORM_SAMPLER_2D_H
+#define PATH_PLANNING_UNIFORM_SAMPLER_2D_H
+
+#include <planning/sampler_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <util/disallow_copy_and_assign.h>
+
+namespace path {
+
+  class UniformSampler2D : public Sampler2D {
+  public:
+    typedef std::shared_ptr<UniformSampler2D> Ptr;
+
+    // Factory method.
+    static UniformSampler2D::Ptr Create(const Scene2DContinuous& scene);
+
+    ~UniformSampler2D() {}
+
+    // Sample 'index' of stream 'stream'.
+    Point2D::Value Sample(uint64_t stream, uint64_t index,
+                          float best_cost) const override;
+
+  private:
+    explicit UniformSampler2D(const Scene2DContinuous& scene)
+      : scene_(scene) {}
+
+    const Scene2DContinuous& scene_;
+
+    DISALLOW_COPY_AND_ASSIGN(UniformSampler2D);
+  };
+
+} //\ namespace path
+
+#endif
@@ -45,6 +45,7 @@
 
 #include <util/types.h>
 #include <geometry/point_2d.h>
+#include <geometry/trajectory_2d.h>
 #include <scene/scene_2d_continuous.h>
 
 namespace path {
@@ -56,9 +57,19 @@ namespace path {
       : scene_(scene), radius_(radius) {}
     ~Robot2DCircular() {}
 
+    // Getter.
+    float GetRadius() const { return radius_; }
+
     // Test if a particular point is feasible.
-    bool IsFeasible(Point2D::Ptr point);
+    bool IsFeasible(Point2D::Ptr point) const;
+    bool IsFeasible(const Point2D::Value& point) const;
+
+    // Test every waypoint of a trajectory, optionally in parallel. Does not
+    // check the segments between waypoints.
+    bool IsFeasible(const Trajectory2D& path, bool parallel = false) const;
     bool LineOfSight(Point2D::Ptr point1, Point2D::Ptr point2) const;
+    bool LineOfSight(const Point2D::Value& point1,
+                     const Point2D::Value& point2) const;
 
   private:
     Scene2DContinuous& scene_;
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class caches a cost field and its gradient on a regular grid over a
+// rectangular region. The grid is split into square tiles that are
+// rasterized the first time a query lands in them, so only the parts of the
+// region a planner actually visits are ever computed. Queries bilinearly
+// interpolate cost and gradient from the four surrounding samples; queries
+// outside the region fall through to the exact evaluator.
+//
+// Queries may run concurrently. A tile is rasterized outside of any lock
+// and published with a compare-and-swap, so two threads racing for the same
+// tile both compute it and one copy is discarded. Invalidate() and Clear()
+// must not run concurrently with queries.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_COST_FIELD_2D_H
+#define PATH_PLANNING_COST_FIELD_2D_H
+
+#include <geometry/point_2d.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace path {
+
+  class CostField2D {
+  public:
+    // Exact cost at a point. If the second argument is not null, also
+    // writes the derivative of cost by position there.
+    typedef std::function<float(const Point2D::Value&, Point2D::Value*)>
+      Evaluator;
+
+    // Cache 'evaluator' over [xmin, xmax] x [ymin, ymax] with samples every
+    // 'resolution' units, in tiles of 'tile_size' x 'tile_size' cells.
+    CostField2D(float xmin, float xmax, float ymin, float ymax,
+                float resolution, int tile_size, const Evaluator& evaluator);
+    ~CostField2D();
+
+    // Interpolated cost, and optionally its derivative, at a point.
+    float Cost(const Point2D::Value& point,
+               Point2D::Value* derivative = nullptr) const;
+
+    // Drop every tile with a sample within 'radius' of 'center' (in the max
+    // norm), e.g. after an obstacle is added there.
+    void Invalidate(const Point2D::Value& center, float radius);
+
+    // Drop every tile.
+    void Clear();
+
+    // Grid parameters.
+    float GetResolution() const;
+    int GetTileSize() const;
+
+    // Number of tiles currently rasterized.
+    int NumCachedTiles() const;
+
+  private:
+    // Interleaved samples, so the two samples of each interpolation row sit
+    // next to each other.
+    struct Sample {
+      float cost;
+      float dx;
+      float dy;
+    };
+
+    // Rasterize one tile; (tile_size_ + 1)^2 samples, row major, including
+    // the shared edges with neighboring tiles.
+    Sample* Rasterize(int tile_x, int tile_y) const;
+
+    // Get a tile, rasterizing it if needed.
+    const Sample* GetTile(int tile_x, int tile_y) const;
+
+    float xmin_, ymin_;
+    float resolution_;
+    int tile_size_;
+    int num_cells_x_, num_cells_y_;
+    int num_tiles_x_, num_tiles_y_;
+    Evaluator evaluator_;
+
+    // Row-major tiles, null until rasterized.
+    std::unique_ptr< std::atomic<Sample*>[] > tiles_;
+
+    DISALLOW_COPY_AND_ASSIGN(CostField2D);
+  };
+
+} //\ namespace path
+
+#endif
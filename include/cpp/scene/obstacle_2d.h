@@ -66,23 +66,31 @@ namespace path {
     static Obstacle2D::Ptr Create(float x, float y, float radius);
 
     // Getters.
-    Point2D::Ptr GetLocation();
-    float GetRadius();
+    Point2D::Ptr GetLocation() const;
+    const Point2D::Value& GetLocationValue() const;
+    float GetRadius() const;
+    const Matrix2f& GetInverseCovariance() const;
+    float GetNormalization() const;
 
     // Feasibility, cost, and derivative evaluation.
     bool IsFeasible(Point2D::Ptr point) const;
+    bool IsFeasible(const Point2D::Value& point) const;
     float Cost(Point2D::Ptr point) const;
+    float Cost(const Point2D::Value& point) const;
     Point2D::Ptr Derivative(Point2D::Ptr point) const;
+    Point2D::Value Derivative(const Point2D::Value& point) const;
 
   private:
     Vector2f mean_;
     Matrix2f cov_;
     float radius_;
     Point2D::Ptr location_;
+    Point2D::Value location_value_;
 
     // For speed.
     Matrix2f inv_;
     float det_;
+    float normalization_;
 
     // Default constructors.
     Obstacle2D(float x, float y,
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class indexes the obstacles in a scene by location with a KdTree2D,
+// for quick nearest neighbor and radius queries. Each obstacle's radius is
+// stored as its extent in the tree. Obstacles are numbered in
+// the order they are added, so queries can hand back indices and never have
+// to map points back to obstacles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_OBSTACLE_2DTREE_H
+#define PATH_PLANNING_OBSTACLE_2DTREE_H
+
+#include <geometry/kdtree_2d.h>
+#include <geometry/point_2d.h>
+#include <scene/obstacle_2d.h>
+#include <scene/obstacle_index_2d.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <vector>
+
+namespace path {
+
+  class Obstacle2DTree : public ObstacleIndex2D {
+  public:
+    Obstacle2DTree() {}
+    ~Obstacle2DTree() {}
+
+    // Add obstacles to the index.
+    void AddObstacle(Obstacle2D::Ptr obstacle) override;
+    void AddObstacles(std::vector<Obstacle2D::Ptr>& obstacles) override;
+
+    // Number of obstacles, and access by index.
+    int Size() const override;
+    const Obstacle2D::Ptr& GetObstacle(int index) const override;
+
+    // Queries the kd tree for the nearest neighbor of 'query'. Returns whether or
+    // not a nearest neighbor was found, and if it was found, the nearest neighbor
+    // and distance to the nearest neighbor.
+    bool NearestNeighbor(Point2D::Ptr query, Obstacle2D::Ptr& nearest,
+                         float& nn_distance) const;
+    bool NearestNeighbor(const Point2D::Value& query, Obstacle2D::Ptr& nearest,
+                         float& nn_distance) const;
+    bool NearestNeighbor(const Point2D::Value& query, int& nearest_index,
+                         float& nn_distance) const override;
+
+    // Queries the kd tree for all neighbors of 'query' within the specified radius.
+    // Returns whether or not any neighbors were found.
+    bool RadiusSearch(Point2D::Ptr query, std::vector<Obstacle2D::Ptr>& neighbors,
+                      float radius) const;
+    bool RadiusSearch(const Point2D::Value& query,
+                      std::vector<Obstacle2D::Ptr>& neighbors,
+                      float radius) const;
+    bool RadiusSearch(const Point2D::Value& query,
+                      std::vector<int>& neighbors,
+                      float radius) const override;
+
+    // Obstacles with |query - center| <= offset + radius_scale * radius.
+    bool ExtentSearch(const Point2D::Value& query, float offset,
+                      float radius_scale,
+                      std::vector<int>& neighbors) const override;
+
+    // Batched queries returning obstacle indices. See KdTree2D for the
+    // layout of the result buffers.
+    void NearestNeighbors(const std::vector<Point2D::Value>& queries,
+                          std::vector<int>& nearest_indices,
+                          std::vector<float>& nn_distances,
+                          bool parallel = false) const override;
+    void RadiusSearch(const std::vector<Point2D::Value>& queries,
+                      std::vector<int>& offsets, std::vector<int>& neighbors,
+                      float radius, bool parallel = false) const override;
+
+    // Calls 'visitor(obstacle)' with a const Obstacle2D& for every obstacle
+    // centered within 'radius' of 'query'. Never allocates.
+    template <typename Visitor>
+    void RadiusVisit(const Point2D::Value& query, float radius,
+                     Visitor visitor) const;
+
+    // Calls 'visitor(obstacle)' with a const Obstacle2D& for every obstacle
+    // with |query - center| <= offset + radius_scale * radius.
+    template <typename Visitor>
+    void ExtentVisit(const Point2D::Value& query, float offset,
+                     float radius_scale, Visitor visitor) const;
+
+    // Same, but calls 'visitor(index)' with the obstacle's index.
+    template <typename Visitor>
+    void ExtentIndexVisit(const Point2D::Value& query, float offset,
+                          float radius_scale, Visitor visitor) const;
+
+  private:
+    KdTree2D kd_tree_;
+    std::vector<Obstacle2D::Ptr> obstacles_;
+
+    DISALLOW_COPY_AND_ASSIGN(Obstacle2DTree);
+  };
+
+  // ------------------- Implementation ------------------- //
+
+  template <typename Visitor>
+  void Obstacle2DTree::RadiusVisit(const Point2D::Value& query, float radius,
+                                   Visitor visitor) const {
+    const std::vector<Obstacle2D::Ptr>& obstacles = obstacles_;
+    kd_tree_.RadiusVisit(query, radius, [&obstacles, &visitor](int index) {
+        visitor(static_cast<const Obstacle2D&>(*obstacles[index]));
+      });
+  }
+
+  template <typename Visitor>
+  void Obstacle2DTree::ExtentVisit(const Point2D::Value& query, float offset,
+                                   float radius_scale, Visitor visitor) const {
+    const std::vector<Obstacle2D::Ptr>& obstacles = obstacles_;
+    kd_tree_.ExtentVisit(query, offset, radius_scale,
+                         [&obstacles, &visitor](int index) {
+        visitor(static_cast<const Obstacle2D&>(*obstacles[index]));
+      });
+  }
+
+  template <typename Visitor>
+  void Obstacle2DTree::ExtentIndexVisit(const Point2D::Value& query,
+                                        float offset, float radius_scale,
+                                        Visitor visitor) const {
+    kd_tree_.ExtentVisit(query, offset, radius_scale, visitor);
+  }
+
+}  //\namespace path
+
+#endif
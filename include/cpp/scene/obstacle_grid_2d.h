@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class indexes the obstacles in a bounded scene with a uniform grid.
+// Obstacles are split into two radius classes. The bulk of them (up to the
+// 95th percentile radius) are bucketed by cell in flat CSR arrays, rebuilt
+// with a counting sort. Cells are about as wide as the largest obstacle in
+// this class, so a feasibility query touches a handful of cells regardless
+// of how many obstacles there are. The few larger ones go to a kd tree that
+// tracks per-obstacle extents, so they never widen the cell search. Single
+// insertions are bucketed straight into their cell, through a per-cell
+// overflow list, or added to the kd tree if they are large, and the grid is
+// rebuilt each time the number of obstacles doubles. Points outside the
+// bounds are clamped into the border cells, so queries stay exact anywhere
+// in the plane.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_OBSTACLE_GRID_2D_H
+#define PATH_PLANNING_OBSTACLE_GRID_2D_H
+
+#include <geometry/kdtree_2d.h>
+#include <geometry/point_2d.h>
+#include <scene/obstacle_2d.h>
+#include <scene/obstacle_index_2d.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace path {
+
+  class ObstacleGrid2D : public ObstacleIndex2D {
+  public:
+    ObstacleGrid2D();
+    ObstacleGrid2D(float xmin, float xmax, float ymin, float ymax);
+    ~ObstacleGrid2D() {}
+
+    // Set the bounds of the grid. Rebuilds the grid.
+    void SetBounds(float xmin, float xmax, float ymin, float ymax);
+
+    // Add obstacles to the index. Adding many at once rebuilds the grid in
+    // one pass.
+    void AddObstacle(Obstacle2D::Ptr obstacle) override;
+    void AddObstacles(std::vector<Obstacle2D::Ptr>& obstacles) override;
+
+    // Number of obstacles, and access by index.
+    int Size() const override;
+    const Obstacle2D::Ptr& GetObstacle(int index) const override;
+
+    // Nearest obstacle center, searching rings of cells outward from the
+    // query until no closer obstacle can exist.
+    bool NearestNeighbor(const Point2D::Value& query, int& nearest_index,
+                         float& nn_distance) const override;
+
+    // All obstacles centered within 'radius' of 'query'.
+    using ObstacleIndex2D::RadiusSearch;
+    bool RadiusSearch(const Point2D::Value& query,
+                      std::vector<int>& neighbors,
+                      float radius) const override;
+
+    // Obstacles with |query - center| <= offset + radius_scale * radius.
+    bool ExtentSearch(const Point2D::Value& query, float offset,
+                      float radius_scale,
+                      std::vector<int>& neighbors) const override;
+
+    // Calls 'visitor(obstacle)' with a const Obstacle2D& for every obstacle
+    // centered within 'radius' of 'query'. Never allocates.
+    template <typename Visitor>
+    void RadiusVisit(const Point2D::Value& query, float radius,
+                     Visitor visitor) const;
+
+    // Calls 'visitor(obstacle)' with a const Obstacle2D& for every obstacle
+    // with |query - center| <= offset + radius_scale * radius.
+    template <typename Visitor>
+    void ExtentVisit(const Point2D::Value& query, float offset,
+                     float radius_scale, Visitor visitor) const;
+
+    // Same, but calls 'visitor(index)' with the obstacle's index.
+    template <typename Visitor>
+    void ExtentIndexVisit(const Point2D::Value& query, float offset,
+                          float radius_scale, Visitor visitor) const;
+
+  private:
+    // Obstacles with their locations and radii, in insertion order.
+    std::vector<Obstacle2D::Ptr> obstacles_;
+    std::vector<Point2D::Value> locations_;
+    std::vector<float> radii_;
+
+    // Grid geometry.
+    float xmin_, xmax_, ymin_, ymax_;
+    float cell_size_;
+    float bucket_radius_;
+    int num_cols_;
+    int num_rows_;
+
+    // Obstacles bucketed by cell: cell ii holds entries
+    // cell_offsets_[ii] .. cell_offsets_[ii + 1] - 1. Locations are copied
+    // alongside the indices so a cell scan reads contiguous memory. Every
+    // bucketed obstacle has radius at most 'bucket_radius_'.
+    std::vector<int> cell_offsets_;
+    std::vector<int> cell_indices_;
+    std::vector<Point2D::Value> cell_locations_;
+    std::vector<float> cell_radii_;
+
+    // Obstacles larger than 'bucket_radius_', and their indices.
+    KdTree2D large_tree_;
+    std::vector<int> large_indices_;
+
+    // Obstacles bucketed one at a time since the last rebuild, as a linked
+    // list per cell: cell ii holds overflow_heads_[ii], then
+    // overflow_next_[overflow_heads_[ii]] and so on, up to -1.
+    std::vector<int> overflow_heads_;
+    std::vector<int> overflow_next_;
+
+    // Number of obstacles at the last rebuild.
+    size_t num_rebuilt_;
+
+    // Rebuild the grid from scratch, choosing new radius classes and a new
+    // cell size.
+    void Rebuild();
+
+    // Clamped cell coordinates.
+    int Column(float x) const;
+    int Row(float y) const;
+
+    // Calls 'visitor(index)' for every obstacle with
+    // |query - center| <= offset + radius_scale * radius. A plain radius
+    // search is the special case radius_scale = 0.
+    template <typename Visitor>
+    void IndexVisit(const Point2D::Value& query, float offset,
+                    float radius_scale, Visitor& visitor) const;
+
+    DISALLOW_COPY_AND_ASSIGN(ObstacleGrid2D);
+  };
+
+  // ------------------- Implementation ------------------- //
+
+  inline int ObstacleGrid2D::Column(float x) const {
+    const float column = (x - xmin_) / cell_size_;
+    if (!(column > 0.0))
+      return 0;
+    if (column >= static_cast<float>(num_cols_))
+      return num_cols_ - 1;
+    return static_cast<int>(column);
+  }
+
+  inline int ObstacleGrid2D::Row(float y) const {
+    const float row = (y - ymin_) / cell_size_;
+    if (!(row > 0.0))
+      return 0;
+    if (row >= static_cast<float>(num_rows_))
+      return num_rows_ - 1;
+    return static_cast<int>(row);
+  }
+
+  template <typename Visitor>
+  void ObstacleGrid2D::IndexVisit(const Point2D::Value& query, float offset,
+                                  float radius_scale, Visitor& visitor) const {
+    // Scan every cell that a bucketed obstacle could reach the query from.
+    const float reach = offset + radius_scale * bucket_radius_;
+    const int column_begin = Column(query.x - reach);
+    const int column_end = Column(query.x + reach);
+    const int row_begin = Row(query.y - reach);
+    const int row_end = Row(query.y + reach);
+
+    for (int row = row_begin; row <= row_end; row++) {
+      const int cell_begin = row * num_cols_ + column_begin;
+      const int cell_end = row * num_cols_ + column_end;
+      for (int ii = cell_offsets_[cell_begin];
+           ii < cell_offsets_[cell_end + 1]; ii++) {
+        const float dx = cell_locations_[ii].x - query.x;
+        const float dy = cell_locations_[ii].y - query.y;
+        const float entry_reach = offset + radius_scale * cell_radii_[ii];
+        if (dx * dx + dy * dy <= entry_reach * entry_reach)
+          visitor(cell_indices_[ii]);
+      }
+
+      // Obstacles bucketed since the last rebuild.
+      for (int cell = cell_begin; cell <= cell_end; cell++) {
+        for (int index = overflow_heads_[cell]; index >= 0;
+             index = overflow_next_[index]) {
+          const float dx = locations_[index].x - query.x;
+          const float dy = locations_[index].y - query.y;
+          const float entry_reach = offset + radius_scale * radii_[index];
+          if (dx * dx + dy * dy <= entry_reach * entry_reach)
+            visitor(index);
+        }
+      }
+    }
+
+    // Large obstacles.
+    const std::vector<int>& large_indices = large_indices_;
+    large_tree_.ExtentVisit(query, offset, radius_scale,
+                            [&large_indices, &visitor](int index) {
+        visitor(large_indices[index]);
+      });
+  }
+
+  template <typename Visitor>
+  void ObstacleGrid2D::RadiusVisit(const Point2D::Value& query, float radius,
+                                   Visitor visitor) const {
+    ExtentVisit(query, radius, 0.0, visitor);
+  }
+
+  template <typename Visitor>
+  void ObstacleGrid2D::ExtentVisit(const Point2D::Value& query, float offset,
+                                   float radius_scale, Visitor visitor) const {
+    const std::vector<Obstacle2D::Ptr>& obstacles = obstacles_;
+    auto obstacle_visitor = [&obstacles, &visitor](int index) {
+      visitor(static_cast<const Obstacle2D&>(*obstacles[index]));
+    };
+    IndexVisit(query, offset, radius_scale, obstacle_visitor);
+  }
+
+  template <typename Visitor>
+  void ObstacleGrid2D::ExtentIndexVisit(const Point2D::Value& query,
+                                        float offset, float radius_scale,
+                                        Visitor visitor) const {
+    IndexVisit(query, offset, radius_scale, visitor);
+  }
+
+}  //\namespace path
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines the interface for spatial indices over the obstacles in
+// a scene. Obstacles are numbered in the order they are added, and queries
+// return those indices.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_OBSTACLE_INDEX_2D_H
+#define PATH_PLANNING_OBSTACLE_INDEX_2D_H
+
+#include <geometry/point_2d.h>
+#include <scene/obstacle_2d.h>
+
+#include <vector>
+
+namespace path {
+
+  class ObstacleIndex2D {
+  public:
+    virtual ~ObstacleIndex2D() {}
+
+    // Add obstacles to the index.
+    virtual void AddObstacle(Obstacle2D::Ptr obstacle) = 0;
+    virtual void AddObstacles(std::vector<Obstacle2D::Ptr>& obstacles) = 0;
+
+    // Number of obstacles, and access by index.
+    virtual int Size() const = 0;
+    virtual const Obstacle2D::Ptr& GetObstacle(int index) const = 0;
+
+    // Find the obstacle whose center is nearest to 'query'. Returns whether or
+    // not one was found.
+    virtual bool NearestNeighbor(const Point2D::Value& query,
+                                 int& nearest_index,
+                                 float& nn_distance) const = 0;
+
+    // Find all obstacles centered within 'radius' of 'query'. Returns whether
+    // or not any were found.
+    virtual bool RadiusSearch(const Point2D::Value& query,
+                              std::vector<int>& neighbors,
+                              float radius) const = 0;
+
+    // Find all obstacles that reach within 'offset' of 'query' when their
+    // radius is scaled by 'radius_scale', i.e. those with
+    // |query - center| <= offset + radius_scale * radius. Unlike a plain
+    // radius search, this does not inflate every query by the largest radius
+    // in the scene. Returns whether or not any were found.
+    virtual bool ExtentSearch(const Point2D::Value& query, float offset,
+                              float radius_scale,
+                              std::vector<int>& neighbors) const = 0;
+
+    // Batched queries. See KdTree2D for the layout of the result buffers.
+    // The default implementations loop over the single queries.
+    virtual void NearestNeighbors(const std::vector<Point2D::Value>& queries,
+                                  std::vector<int>& nearest_indices,
+                                  std::vector<float>& nn_distances,
+                                  bool parallel = false) const;
+    virtual void RadiusSearch(const std::vector<Point2D::Value>& queries,
+                              std::vector<int>& offsets,
+                              std::vector<int>& neighbors,
+                              float radius, bool parallel = false) const;
+  };
+
+}  //\namespace path
+
+#endif
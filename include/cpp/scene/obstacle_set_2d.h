@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class packs the cost parameters of a set of Obstacle2Ds into flat
+// arrays (structure of arrays): mean, the three distinct entries of the
+// inverse covariance, and the normalization constant. Cost and derivative
+// are evaluated eight obstacles at a time with AVX2 when the library is
+// built with it (e.g. -DBUILD_NATIVE=ON), four at a time with SSE2 (the
+// x86-64 baseline) otherwise, and with a scalar loop on other targets.
+// Arrays are padded with zero-weight entries to a multiple of the vector
+// width, so the kernels never need a remainder loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_PLANNING_OBSTACLE_SET_2D_H
+#define PATH_PLANNING_OBSTACLE_SET_2D_H
+
+#include <geometry/point_2d.h>
+#include <scene/obstacle_2d.h>
+#include <util/types.h>
+#include <util/disallow_copy_and_assign.h>
+
+#include <vector>
+
+namespace path {
+
+  class ObstacleSet2D {
+  public:
+    ObstacleSet2D();
+    ~ObstacleSet2D() {}
+
+    // Add an obstacle. Obstacles are numbered in insertion order.
+    void AddObstacle(const Obstacle2D& obstacle);
+
+    // Number of obstacles, and removal of all of them.
+    size_t Size() const;
+    void Clear();
+
+    // Total cost at 'point' from every obstacle. If 'derivative' is not null,
+    // also compute the derivative of the total cost by position.
+    float Cost(const Point2D::Value& point,
+               Point2D::Value* derivative = nullptr) const;
+
+    // Same, but only from the 'count' obstacles listed in 'indices'.
+    float Cost(const Point2D::Value& point, const int* indices, size_t count,
+               Point2D::Value* derivative = nullptr) const;
+
+    // Total cost at each of many points from every obstacle. Results go into
+    // caller-provided buffers, which are resized to fit.
+    void Cost(const std::vector<Point2D::Value>& points,
+              std::vector<float>& costs,
+              std::vector<Point2D::Value>* derivatives = nullptr) const;
+
+  private:
+    // Number of real (unpadded) obstacles.
+    size_t size_;
+
+    // Padded arrays. Entry ii has mean (x_, y_), inverse covariance
+    // [a_ b_; b_ c_], and normalization weight_. Padding entries have zero
+    // weight. There is always at least one padding entry, at index size_.
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> a_;
+    std::vector<float> b_;
+    std::vector<float> c_;
+    std::vector<float> weight_;
+
+    // Resize the arrays to hold 'size' obstacles plus padding.
+    void Pad(size_t size);
+
+    DISALLOW_COPY_AND_ASSIGN(ObstacleSet2D);
+  };
+
+} //\ namespace path
+
+#endif
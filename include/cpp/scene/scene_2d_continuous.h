@@ -46,11 +46,18 @@
 #include <scene/obstacle_2d.h>
 #include <geometry/point_2d.h>
 #include <geometry/trajectory_2d.h>
-#include <flann/flann_obstacle_2dtree.h>
+#include <scene/cost_field_2d.h>
+#include <scene/obstacle_2dtree.h>
+#include <scene/obstacle_grid_2d.h>
+#include <scene/obstacle_index_2d.h>
+#include <scene/obstacle_set_2d.h>
 #include <util/types.h>
 #include <image/image.h>
 #include <math/random_generator.h>
+#include <math/counter_generator.h>
 
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -59,45 +66,115 @@ namespace path {
   // Derived class to model 2D continuous scenes.
   class Scene2DContinuous {
   public:
-    Scene2DContinuous();
+    // Spatial index used for obstacle queries. The kd tree works for any
+    // layout; the uniform grid is faster for dense, roughly uniform obstacle
+    // fields within the scene bounds.
+    typedef enum {
+      KD_TREE = 0,
+      UNIFORM_GRID = 1,
+    } IndexType;
+
+    Scene2DContinuous(IndexType index_type = KD_TREE);
     Scene2DContinuous(float xmin, float xmax,
-                      float ymin, float ymax);
+                      float ymin, float ymax,
+                      IndexType index_type = KD_TREE);
     Scene2DContinuous(float xmin, float xmax,
                       float ymin, float ymax,
-                      std::vector<Obstacle2D::Ptr>& obstacles);
+                      std::vector<Obstacle2D::Ptr>& obstacles,
+                      IndexType index_type = KD_TREE);
 
     // Add an obstacle.
     void AddObstacle(Obstacle2D::Ptr obstacle);
 
     // Get obstacles.
     std::vector<Obstacle2D::Ptr>& GetObstacles();
-    FlannObstacle2DTree& GetObstacleTree();
+    const ObstacleIndex2D& GetObstacleIndex() const;
+    IndexType GetIndexType() const;
     float GetLargestObstacleRadius() const;
     int GetObstacleCount() const;
 
+    // Calls 'visitor(obstacle)' with a const Obstacle2D& for every obstacle
+    // centered within 'radius' of 'query'. Never allocates.
+    template <typename Visitor>
+    void VisitObstacles(const Point2D::Value& query, float radius,
+                        Visitor visitor) const;
+
+    // Calls 'visitor(obstacle)' for every obstacle with
+    // |query - center| <= offset + radius_scale * radius. Prefer this to
+    // inflating a radius search by the largest obstacle radius.
+    template <typename Visitor>
+    void VisitObstacles(const Point2D::Value& query, float offset,
+                        float radius_scale, Visitor visitor) const;
+
     // Setter.
     void SetBounds(float xmin, float xmax, float ymin, float ymax);
 
+    // Is this point within the scene bounds?
+    bool IsInBounds(const Point2D::Value& point) const;
+
+    // Getters.
+    float GetXMin() const { return xmin_; }
+    float GetXMax() const { return xmax_; }
+    float GetYMin() const { return ymin_; }
+    float GetYMax() const { return ymax_; }
+
     // Is this point feasible?
     bool IsFeasible(Point2D::Ptr point) const;
+    bool IsFeasible(const Point2D::Value& point) const;
 
     // What is the cost of occupying this point?
     float Cost(Point2D::Ptr point) const;
+    float Cost(const Point2D::Value& point) const;
+
+    // Cost and its derivative by position from a single evaluation.
+    float Cost(const Point2D::Value& point, Point2D::Value* derivative) const;
 
     // Compute the derivative of cost by position. This is used for
     // trajectory optimization.
     Point2D::Ptr CostDerivative(Point2D::Ptr point) const;
-
-    // Get a random point in the scene.
+    Point2D::Value CostDerivative(const Point2D::Value& point) const;
+
+    // Cache cost and its derivative over the scene bounds, on a grid with
+    // the given spacing. Tiles of 'tile_size' x 'tile_size' cells are
+    // computed on first use, and afterwards Cost() and CostDerivative()
+    // interpolate the cached values. Adding an obstacle recomputes only the
+    // tiles it affects.
+    void EnableCostCache(float resolution, int tile_size = 32);
+    void DisableCostCache();
+    bool IsCostCacheEnabled() const;
+
+    // Get a random point in the scene. Calls are serialized on a lock shared
+    // by all threads; concurrent samplers should use the indexed overloads
+    // below instead.
     Point2D::Ptr GetRandomPoint() const;
-
-    // Optimize the given trajectory to minimize cost.
+    Point2D::Value GetRandomPointValue() const;
+
+    // Get random point 'index' of sample stream 'stream'. The point depends
+    // only on the sample seed, 'stream' and 'index', so samplers running on
+    // any number of threads reproduce a serial run exactly.
+    Point2D::Ptr GetRandomPoint(uint64_t stream, uint64_t index) const;
+    Point2D::Value GetRandomPointValue(uint64_t stream, uint64_t index) const;
+
+    // Seed for indexed random points. Defaults to 0.
+    void SetSampleSeed(uint64_t seed);
+    uint64_t GetSampleSeed() const;
+
+    // Optimize the given trajectory to minimize cost. The result trades
+    // 'gradient_weight' times obstacle cost against 'gradient_weight' *
+    // 'curvature_penalty' times squared waypoint spacing, and is solved
+    // with TrajectoryOptimizer2D, which stops roughly once waypoints move
+    // less than 'min_avg_displacement' on average per step. That threshold
+    // is converted to the solver's relative step tolerance using the size
+    // of the initial path. 'max_point_displacement' is deprecated and
+    // ignored, with a warning if it is set, since the trust region bounds
+    // each step. 'parallel' evaluates waypoints concurrently.
     Trajectory2D::Ptr OptimizeTrajectory(Trajectory2D::Ptr path,
                                          float gradient_weight = 1e-6,
                                          float curvature_penalty = 1e-5,
                                          float max_point_displacement = 1e-2,
                                          float min_avg_displacement = 1e-4,
-                                         size_t max_iters = 100) const;
+                                         size_t max_iters = 100,
+                                         bool parallel = false) const;
 
     // Visualize this scene. Optionally pass in the number of pixels
     // in the x-direction.
@@ -111,8 +188,14 @@ namespace path {
 
   private:
     std::vector<Obstacle2D::Ptr> obstacles_;
-    FlannObstacle2DTree obstacle_tree_;
+    IndexType index_type_;
+    Obstacle2DTree obstacle_tree_;
+    ObstacleGrid2D obstacle_grid_;
+    ObstacleSet2D obstacle_set_;
+    std::unique_ptr<CostField2D> cost_field_;
     math::RandomGenerator rng_;
+    mutable std::mutex rng_mutex_;
+    math::CounterGenerator sampler_;
     float largest_obstacle_radius_;
 
     float xmin_;
@@ -120,9 +203,52 @@ namespace path {
     float ymin_;
     float ymax_;
 
+    // Calls 'visitor(index)' for every obstacle with
+    // |query - center| <= offset + radius_scale * radius.
+    template <typename Visitor>
+    void VisitObstacleIndices(const Point2D::Value& query, float offset,
+                              float radius_scale, Visitor visitor) const;
+
+    // Exact cost, and optionally its derivative, from nearby obstacles.
+    float EvaluateCost(const Point2D::Value& point,
+                       Point2D::Value* derivative) const;
+
     DISALLOW_COPY_AND_ASSIGN(Scene2DContinuous);
   };
 
+  // ------------------- Implementation ------------------- //
+
+  template <typename Visitor>
+  void Scene2DContinuous::VisitObstacles(const Point2D::Value& query,
+                                         float radius,
+                                         Visitor visitor) const {
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.RadiusVisit(query, radius, visitor);
+    else
+      obstacle_tree_.RadiusVisit(query, radius, visitor);
+  }
+
+  template <typename Visitor>
+  void Scene2DContinuous::VisitObstacles(const Point2D::Value& query,
+                                         float offset, float radius_scale,
+                                         Visitor visitor) const {
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.ExtentVisit(query, offset, radius_scale, visitor);
+    else
+      obstacle_tree_.ExtentVisit(query, offset, radius_scale, visitor);
+  }
+
+  template <typename Visitor>
+  void Scene2DContinuous::VisitObstacleIndices(const Point2D::Value& query,
+                                               float offset,
+                                               float radius_scale,
+                                               Visitor visitor) const {
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.ExtentIndexVisit(query, offset, radius_scale, visitor);
+    else
+      obstacle_tree_.ExtentIndexVisit(query, offset, radius_scale, visitor);
+  }
+
 } // \namespace path
 
 #endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines a flag that one thread sets to ask long-running work on
+// other threads, such as a planner, to stop early. Share it by pointer.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_UTIL_CANCELLATION_TOKEN_H
+#define PATH_UTIL_CANCELLATION_TOKEN_H
+
+#include <util/disallow_copy_and_assign.h>
+
+#include <atomic>
+#include <memory>
+
+namespace path {
+namespace util {
+
+class CancellationToken {
+public:
+ typedef std::shared_ptr<CancellationToken> Ptr;
+
+ // Factory method.
+ static Ptr Create() { return Ptr(new CancellationToken()); }
+
+ ~CancellationToken() {}
+
+ // Request cancellation. Safe to call from any thread.
+ void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+ // Has cancellation been requested?
+ bool IsCancelled() const {
+   return cancelled_.load(std::memory_order_relaxed);
+ }
+
+private:
+ CancellationToken() : cancelled_(false) {}
+
+ std::atomic<bool> cancelled_;
+
+ DISALLOW_COPY_AND_ASSIGN(CancellationToken);
+
+}; //\class CancellationToken
+
+} //\namespace util
+} //\namespace path
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines a wall-clock deadline on a monotonic clock, for bounding
+// the time spent in anytime algorithms such as the sampling planners.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PATH_UTIL_DEADLINE_H
+#define PATH_UTIL_DEADLINE_H
+
+#include <chrono>
+
+namespace path {
+namespace util {
+
+class Deadline {
+public:
+ typedef std::chrono::steady_clock Clock;
+
+ // A deadline that never expires.
+ Deadline();
+ ~Deadline() {}
+
+ // A deadline 'seconds' from now.
+ static Deadline In(double seconds);
+
+ // A deadline that never expires.
+ static Deadline Never();
+
+ // Has the deadline passed?
+ bool Expired() const;
+
+ // Seconds left before the deadline, or a negative number if it has passed.
+ // Infinite for a deadline that never expires.
+ double Remaining() const;
+
+private:
+ Clock::time_point time_;
+ bool never_;
+
+}; //\class Deadline
+
+} //\namespace util
+} //\namespace path
+
+#endif
@@ -124,11 +124,11 @@ class Status {
   }
 
   // Easy function to check for success.
-  inline bool ok() { return code_ == OK; }
+  inline bool ok() const { return code_ == OK; }
 
   // Getters.
-  inline const Code& ErrorCode() { return code_; }
-  inline const std::string& Message() { return msg_; }
+  inline const Code& ErrorCode() const { return code_; }
+  inline const std::string& Message() const { return msg_; }
 
  private:
   Code code_;
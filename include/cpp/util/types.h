@@ -55,6 +55,17 @@ namespace path {
   // -------------------- Custom types -------------------- //
   namespace Point2D {
     typedef std::shared_ptr<::pcl::PointXY> Ptr;
+
+    // Plain 8-byte value type with the same layout as ::pcl::PointXY. Use
+    // this in hot paths to avoid a heap allocation per point.
+    struct Value {
+      float x;
+      float y;
+
+      Value() : x(0.0), y(0.0) {}
+      Value(float x, float y) : x(x), y(y) {}
+      explicit Value(const ::pcl::PointXY& point) : x(point.x), y(point.y) {}
+    };
   }
 
   namespace Point3D {
@@ -69,7 +69,12 @@ namespace path {
                                             Obstacle2D::Ptr& nearest,
                                             float& nn_distance) const {
     CHECK_NOTNULL(query.get());
+    return NearestNeighbor(Point2D::Value(*query), nearest, nn_distance);
+  }
 
+  bool FlannObstacle2DTree::NearestNeighbor(const Point2D::Value& query,
+                                            Obstacle2D::Ptr& nearest,
+                                            float& nn_distance) const {
     // Query kd_tree_.
     Point2D::Ptr nearest_point;
     if (!kd_tree_.NearestNeighbor(query, nearest_point, nn_distance))
@@ -86,7 +91,12 @@ namespace path {
                                          std::vector<Obstacle2D::Ptr>& neighbors,
                                          float radius) const {
     CHECK_NOTNULL(query.get());
+    return RadiusSearch(Point2D::Value(*query), neighbors, radius);
+  }
 
+  bool FlannObstacle2DTree::RadiusSearch(const Point2D::Value& query,
+                                         std::vector<Obstacle2D::Ptr>& neighbors,
+                                         float radius) const {
     // Query kd_tree_.
     std::vector<Point2D::Ptr> nearest_points;
     if (!kd_tree_.RadiusSearch(query, nearest_points, radius))
@@ -47,6 +47,7 @@
 #include <glog/logging.h>
 #include <iostream>
 #include <cmath>
+#include <limits>
 
 namespace path {
 
@@ -62,6 +63,8 @@ namespace path {
 
   // Number of points in the tree.
   int FlannPoint2DTree::Size() const {
+    if (index_ == nullptr)
+      return 0;
     return index_->size();
   }
 
@@ -94,6 +97,10 @@ namespace path {
     index_->addPoints(flann_point, kRebuildThreshold);
   }
 
+  void FlannPoint2DTree::AddPoint(const Point2D::Value& point) {
+    AddPoint(Point2D::Create(point));
+  }
+
   // Add points to the index.
   void FlannPoint2DTree::AddPoints(std::vector<Point2D::Ptr>& points) {
     for (auto& point : points) {
@@ -105,22 +112,40 @@ namespace path {
   bool FlannPoint2DTree::NearestNeighbor(Point2D::Ptr query, Point2D::Ptr& nearest,
                                          float& nn_distance) const {
     CHECK_NOTNULL(query.get());
+    return NearestNeighbor(Point2D::Value(*query), nearest, nn_distance);
+  }
+
+  bool FlannPoint2DTree::NearestNeighbor(const Point2D::Value& query,
+                                         Point2D::Ptr& nearest,
+                                         float& nn_distance) const {
+    int nearest_index = -1;
+    if (!NearestNeighbor(query, nearest_index, nn_distance))
+      return false;
+
+    nearest = registry_[nearest_index];
+    return true;
+  }
 
+  bool FlannPoint2DTree::NearestNeighbor(const Point2D::Value& query,
+                                         int& nearest_index,
+                                         float& nn_distance) const {
     if (index_ == nullptr) {
       VLOG(1) << "Index has not been built. Points must be added before "
               <<  "querying the kd tree";
       return false;
     }
 
-    // Convert the input point to the FLANN format.
+    // Convert the input point to the FLANN format. Query and output buffers
+    // live on the stack so that this call does not touch the heap.
     const int kNumColumns = 2;
-    flann::Matrix<double> flann_query(new double[kNumColumns], 1, kNumColumns);
-    flann_query[0][0] = query->x;
-    flann_query[0][1] = query->y;
+    double query_data[kNumColumns] = { query.x, query.y };
+    flann::Matrix<double> flann_query(query_data, 1, kNumColumns);
 
     // Search the kd tree for the nearest neighbor to the query.
-    std::vector< std::vector<int> > query_match_indices;
-    std::vector< std::vector<double> > query_distances;
+    int match_index = -1;
+    double match_distance = 0.0;
+    flann::Matrix<int> query_match_indices(&match_index, 1, 1);
+    flann::Matrix<double> query_distances(&match_distance, 1, 1);
 
     const int kOneNearestNeighbor = 1;
     int num_neighbors_found = index_->knnSearch(
@@ -128,9 +153,9 @@ namespace path {
        flann::SearchParams(flann::FLANN_CHECKS_UNLIMITED) /* no approx */);
 
     // If we found a nearest neighbor, assign output.
-    if (num_neighbors_found > 0) {
-      nearest = registry_[ query_match_indices[0][0] ];
-      nn_distance = std::sqrt(query_distances[0][0]);
+    if (num_neighbors_found > 0 && match_index >= 0) {
+      nearest_index = match_index;
+      nn_distance = std::sqrt(match_distance);
       return true;
     }
 
@@ -143,7 +168,12 @@ namespace path {
                                       std::vector<Point2D::Ptr>& neighbors,
                                       float radius) const {
     CHECK_NOTNULL(query.get());
+    return RadiusSearch(Point2D::Value(*query), neighbors, radius);
+  }
 
+  bool FlannPoint2DTree::RadiusSearch(const Point2D::Value& query,
+                                      std::vector<Point2D::Ptr>& neighbors,
+                                      float radius) const {
     if (index_ == nullptr) {
       VLOG(1) << "Index has not been built. Points must be added before "
               << "querying the kd tree";
@@ -152,17 +182,17 @@ namespace path {
 
     // Convert the input point to the FLANN format.
     const int kNumColumns = 2;
-    flann::Matrix<double> flann_query(new double[kNumColumns], 1, kNumColumns);
-    flann_query[0][0] = query->x;
-    flann_query[0][1] = query->y;
+    double query_data[kNumColumns] = { query.x, query.y };
+    flann::Matrix<double> flann_query(query_data, 1, kNumColumns);
 
-    // Search the kd tree for the nearest neighbor to the query.
+    // Search the kd tree for the nearest neighbor to the query. FLANN's L2
+    // distance is squared, so the radius must be squared as well.
     std::vector< std::vector<int> > query_match_indices;
     std::vector< std::vector<double> > query_distances;
 
     int num_neighbors_found =
       index_->radiusSearch(flann_query, query_match_indices,
-                           query_distances, static_cast<float>(radius),
+                           query_distances, radius * radius,
                            flann::SearchParams(flann::FLANN_CHECKS_UNLIMITED));
 
     // If we found a nearest neighbor, assign output.
@@ -173,4 +203,103 @@ namespace path {
     return true;
   }
 
+  // Batched nearest neighbor queries.
+  bool FlannPoint2DTree::NearestNeighbors(
+                              const std::vector<Point2D::Value>& queries,
+                              std::vector<int>& nearest_indices,
+                              std::vector<float>& nn_distances,
+                              bool parallel) const {
+    const size_t num_queries = queries.size();
+    nearest_indices.assign(num_queries, -1);
+    nn_distances.assign(num_queries, std::numeric_limits<float>::infinity());
+
+    if (index_ == nullptr) {
+      VLOG(1) << "Index has not been built. Points must be added before "
+              << "querying the kd tree";
+      return false;
+    }
+
+    if (num_queries == 0)
+      return true;
+
+    // Convert the queries to the FLANN format.
+    const int kNumColumns = 2;
+    std::vector<double> query_data(kNumColumns * num_queries);
+    for (size_t ii = 0; ii < num_queries; ii++) {
+      query_data[kNumColumns * ii] = queries[ii].x;
+      query_data[kNumColumns * ii + 1] = queries[ii].y;
+    }
+    flann::Matrix<double> flann_queries(query_data.data(), num_queries,
+                                        kNumColumns);
+
+    // Search the kd tree. Indices are written straight into the output.
+    std::vector<double> match_distances(num_queries);
+    flann::Matrix<int> query_match_indices(nearest_indices.data(),
+                                           num_queries, 1);
+    flann::Matrix<double> query_distances(match_distances.data(),
+                                          num_queries, 1);
+
+    flann::SearchParams params(flann::FLANN_CHECKS_UNLIMITED);
+    params.cores = parallel ? 0 /* all cores */ : 1;
+
+    const int kOneNearestNeighbor = 1;
+    index_->knnSearch(flann_queries, query_match_indices, query_distances,
+                      kOneNearestNeighbor, params);
+
+    for (size_t ii = 0; ii < num_queries; ii++) {
+      if (nearest_indices[ii] >= 0)
+        nn_distances[ii] = std::sqrt(match_distances[ii]);
+    }
+
+    return true;
+  }
+
+  // Batched radius queries.
+  bool FlannPoint2DTree::RadiusSearch(const std::vector<Point2D::Value>& queries,
+                                      std::vector<int>& offsets,
+                                      std::vector<int>& neighbors,
+                                      float radius, bool parallel) const {
+    const size_t num_queries = queries.size();
+    offsets.assign(num_queries + 1, 0);
+    neighbors.clear();
+
+    if (index_ == nullptr) {
+      VLOG(1) << "Index has not been built. Points must be added before "
+              << "querying the kd tree";
+      return false;
+    }
+
+    if (num_queries == 0)
+      return true;
+
+    // Convert the queries to the FLANN format.
+    const int kNumColumns = 2;
+    std::vector<double> query_data(kNumColumns * num_queries);
+    for (size_t ii = 0; ii < num_queries; ii++) {
+      query_data[kNumColumns * ii] = queries[ii].x;
+      query_data[kNumColumns * ii + 1] = queries[ii].y;
+    }
+    flann::Matrix<double> flann_queries(query_data.data(), num_queries,
+                                        kNumColumns);
+
+    // Search the kd tree. FLANN's L2 distance is squared.
+    std::vector< std::vector<int> > query_match_indices;
+    std::vector< std::vector<double> > query_distances;
+
+    flann::SearchParams params(flann::FLANN_CHECKS_UNLIMITED);
+    params.cores = parallel ? 0 /* all cores */ : 1;
+
+    index_->radiusSearch(flann_queries, query_match_indices, query_distances,
+                         radius * radius, params);
+
+    // Flatten to CSR.
+    for (size_t ii = 0; ii < num_queries; ii++) {
+      neighbors.insert(neighbors.end(), query_match_indices[ii].begin(),
+                       query_match_indices[ii].end());
+      offsets[ii + 1] = static_cast<int>(neighbors.size());
+    }
+
+    return true;
+  }
+
 }  //\namespace path
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines an incremental kd tree over 2D points, tuned for
+// insert-heavy workloads such as growing an RRT.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <geometry/kdtree_2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glog/logging.h>
+
+namespace path {
+
+  namespace {
+
+    // Orders entries along one axis.
+    template <typename Entry>
+    struct AxisLess {
+      explicit AxisLess(int axis) : axis_(axis) {}
+      bool operator()(const Entry& lhs, const Entry& rhs) const {
+        return (axis_ == 0) ? lhs.x < rhs.x : lhs.y < rhs.y;
+      }
+      int axis_;
+    };
+
+  } //\ namespace
+
+  // Number of points in the tree.
+  int KdTree2D::Size() const {
+    return static_cast<int>(points_.size());
+  }
+
+  // Add a point to the index, returning its index.
+  int KdTree2D::AddPoint(const Point2D::Value& point, float extent) {
+    points_.push_back(point);
+    extents_.push_back(extent);
+    removed_.push_back(0);
+    num_buffered_++;
+
+    if (num_buffered_ >= kBufferSize)
+      Carry();
+
+    return static_cast<int>(points_.size()) - 1;
+  }
+
+  void KdTree2D::AddPoints(const std::vector<Point2D::Value>& points) {
+    points_.reserve(points_.size() + points.size());
+    extents_.reserve(extents_.size() + points.size());
+    removed_.reserve(removed_.size() + points.size());
+    for (const auto& point : points)
+      AddPoint(point);
+  }
+
+  // Get a point by index.
+  const Point2D::Value& KdTree2D::GetPoint(int index) const {
+    CHECK(index >= 0 && index < Size());
+    return points_[index];
+  }
+
+  float KdTree2D::GetExtent(int index) const {
+    CHECK(index >= 0 && index < Size());
+    return extents_[index];
+  }
+
+  // Remove all points.
+  void KdTree2D::Clear() {
+    points_.clear();
+    extents_.clear();
+    trees_.clear();
+    removed_.clear();
+    num_buffered_ = 0;
+    num_removed_ = 0;
+  }
+
+  // Remove or restore a single point.
+  void KdTree2D::Remove(int index) {
+    CHECK(index >= 0 && index < Size());
+    if (!removed_[index]) {
+      removed_[index] = 1;
+      num_removed_++;
+    }
+  }
+
+  void KdTree2D::Restore(int index) {
+    CHECK(index >= 0 && index < Size());
+    if (removed_[index]) {
+      removed_[index] = 0;
+      num_removed_--;
+    }
+  }
+
+  bool KdTree2D::IsRemoved(int index) const {
+    CHECK(index >= 0 && index < Size());
+    return removed_[index] != 0;
+  }
+
+  // Queries the kd tree for the nearest neighbor of 'query'.
+  bool KdTree2D::NearestNeighbor(const Point2D::Value& query,
+                                 int& nearest_index,
+                                 float& nn_distance) const {
+    if (points_.empty()) {
+      VLOG(1) << "Tree is empty. Cannot find nearest neighbor.";
+      return false;
+    }
+
+    nearest_index = -1;
+    float nn_distance_sq = std::numeric_limits<float>::infinity();
+    const uint8_t* removed = (num_removed_ > 0) ? removed_.data() : nullptr;
+
+    // Scan the buffer.
+    for (size_t ii = points_.size() - num_buffered_; ii < points_.size(); ii++) {
+      const float dx = points_[ii].x - query.x;
+      const float dy = points_[ii].y - query.y;
+      const float distance_sq = dx * dx + dy * dy;
+      if (distance_sq < nn_distance_sq &&
+          (removed == nullptr || !removed[ii])) {
+        nn_distance_sq = distance_sq;
+        nearest_index = static_cast<int>(ii);
+      }
+    }
+
+    // Search each tree, largest first since it is most likely to contain
+    // the answer and tighten the bound for the others.
+    for (size_t ii = trees_.size(); ii-- > 0; ) {
+      const std::vector<Entry>& entries = trees_[ii];
+      if (!entries.empty())
+        NearestNeighbor(entries, 0, entries.size(), 0, query, removed,
+                        nearest_index, nn_distance_sq);
+    }
+
+    nn_distance = std::sqrt(nn_distance_sq);
+    return nearest_index >= 0;
+  }
+
+  // Queries the kd tree for all neighbors of 'query' within the specified
+  // radius.
+  bool KdTree2D::RadiusSearch(const Point2D::Value& query,
+                              std::vector<int>& neighbors,
+                              float radius) const {
+    neighbors.clear();
+    RadiusVisit(query, radius, [&neighbors](int index) {
+        neighbors.push_back(index);
+      });
+
+    return !neighbors.empty();
+  }
+
+  // Batched nearest neighbor queries.
+  void KdTree2D::NearestNeighbors(const std::vector<Point2D::Value>& queries,
+                                  std::vector<int>& nearest_indices,
+                                  std::vector<float>& nn_distances,
+                                  bool parallel) const {
+    const long num_queries = static_cast<long>(queries.size());
+    nearest_indices.resize(num_queries);
+    nn_distances.resize(num_queries);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (long ii = 0; ii < num_queries; ii++) {
+      if (!NearestNeighbor(queries[ii], nearest_indices[ii], nn_distances[ii])) {
+        nearest_indices[ii] = -1;
+        nn_distances[ii] = std::numeric_limits<float>::infinity();
+      }
+    }
+  }
+
+  // Batched radius queries. Neighbors are counted in a first pass so that
+  // every query knows where its results start, then written in a second
+  // pass. Both passes are independent across queries.
+  void KdTree2D::RadiusSearch(const std::vector<Point2D::Value>& queries,
+                              std::vector<int>& offsets,
+                              std::vector<int>& neighbors,
+                              float radius, bool parallel) const {
+    const long num_queries = static_cast<long>(queries.size());
+    offsets.resize(num_queries + 1);
+    offsets[0] = 0;
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (long ii = 0; ii < num_queries; ii++) {
+      int count = 0;
+      RadiusVisit(queries[ii], radius, [&count](int) { count++; });
+      offsets[ii + 1] = count;
+    }
+
+    for (long ii = 0; ii < num_queries; ii++)
+      offsets[ii + 1] += offsets[ii];
+    neighbors.resize(offsets[num_queries]);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (long ii = 0; ii < num_queries; ii++) {
+      int* output = neighbors.data() + offsets[ii];
+      RadiusVisit(queries[ii], radius, [&output](int index) {
+          *output++ = index;
+        });
+    }
+  }
+
+  // Merge the buffer and all smaller trees into the first empty tree.
+  void KdTree2D::Carry() {
+    // Find the first empty tree. Trees below it are all full.
+    size_t level = 0;
+    while (level < trees_.size() && !trees_[level].empty())
+      level++;
+    if (level == trees_.size())
+      trees_.resize(level + 1);
+
+    std::vector<Entry>& merged = trees_[level];
+    merged.reserve(kBufferSize << level);
+
+    for (size_t ii = 0; ii < level; ii++) {
+      merged.insert(merged.end(), trees_[ii].begin(), trees_[ii].end());
+      std::vector<Entry>().swap(trees_[ii]);
+    }
+
+    for (size_t ii = points_.size() - num_buffered_; ii < points_.size(); ii++) {
+      Entry entry;
+      entry.x = points_[ii].x;
+      entry.y = points_[ii].y;
+      entry.index = static_cast<int>(ii);
+      entry.extent = extents_[ii];
+      entry.max_extent = extents_[ii];
+      merged.push_back(entry);
+    }
+
+    num_buffered_ = 0;
+    Build(merged, 0, merged.size(), 0);
+  }
+
+  // Arrange entries [begin, end) into an implicit kd tree, recording the
+  // largest extent below each split.
+  float KdTree2D::Build(std::vector<Entry>& entries, size_t begin, size_t end,
+                        int depth) {
+    if (end - begin <= kLeafSize) {
+      float max_extent = 0.0;
+      for (size_t ii = begin; ii < end; ii++)
+        max_extent = std::max(max_extent, entries[ii].extent);
+      return max_extent;
+    }
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(entries.begin() + begin, entries.begin() + middle,
+                     entries.begin() + end, AxisLess<Entry>(depth & 1));
+
+    Entry& split = entries[middle];
+    split.max_extent = std::max(split.extent,
+      std::max(Build(entries, begin, middle, depth + 1),
+               Build(entries, middle + 1, end, depth + 1)));
+    return split.max_extent;
+  }
+
+  // Recursive nearest neighbor query on one tree.
+  void KdTree2D::NearestNeighbor(const std::vector<Entry>& entries,
+                                 size_t begin, size_t end, int depth,
+                                 const Point2D::Value& query,
+                                 const uint8_t* removed,
+                                 int& nearest_index, float& nn_distance_sq) {
+    // Small ranges are scanned linearly.
+    if (end - begin <= kLeafSize) {
+      for (size_t ii = begin; ii < end; ii++) {
+        const float dx = entries[ii].x - query.x;
+        const float dy = entries[ii].y - query.y;
+        const float distance_sq = dx * dx + dy * dy;
+        if (distance_sq < nn_distance_sq &&
+            (removed == nullptr || !removed[entries[ii].index])) {
+          nn_distance_sq = distance_sq;
+          nearest_index = entries[ii].index;
+        }
+      }
+
+      return;
+    }
+
+    // Check the splitting entry.
+    const size_t middle = begin + (end - begin) / 2;
+    const Entry& split = entries[middle];
+    const float dx = split.x - query.x;
+    const float dy = split.y - query.y;
+    const float distance_sq = dx * dx + dy * dy;
+    if (distance_sq < nn_distance_sq &&
+        (removed == nullptr || !removed[split.index])) {
+      nn_distance_sq = distance_sq;
+      nearest_index = split.index;
+    }
+
+    // Descend into the near side first, then the far side only if the
+    // splitting plane is closer than the best match so far.
+    const float offset = (depth & 1) ? query.y - split.y : query.x - split.x;
+    if (offset < 0.0) {
+      NearestNeighbor(entries, begin, middle, depth + 1, query, removed,
+                      nearest_index, nn_distance_sq);
+      if (offset * offset < nn_distance_sq)
+        NearestNeighbor(entries, middle + 1, end, depth + 1, query, removed,
+                        nearest_index, nn_distance_sq);
+    } else {
+      NearestNeighbor(entries, middle + 1, end, depth + 1, query, removed,
+                      nearest_index, nn_distance_sq);
+      if (offset * offset < nn_distance_sq)
+        NearestNeighbor(entries, begin, middle, depth + 1, query, removed,
+                        nearest_index, nn_distance_sq);
+    }
+  }
+
+} //\ namespace path
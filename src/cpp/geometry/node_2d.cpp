@@ -44,31 +44,6 @@
 
 namespace path {
 
-  // Factory method.
-  Node2D::Ptr Node2D::Create(const Point2D::Ptr data) {
-    Node2D::Ptr node(new Node2D(data));
-    return node;
-  }
-
-  // Getters and setters.
-  void Node2D::SetParent(Node2D::Ptr parent) {
-    parent_ = parent;
-  }
-
-  Node2D::Ptr Node2D::GetParent() {
-    return parent_;
-  }
-
-  void Node2D::AddChild(Node2D::Ptr child) {
-    children_.push_back(child);
-  }
-
-  std::vector<Node2D::Ptr>& Node2D::GetChildren() {
-    return children_;
-  }
-
-  Point2D::Ptr Node2D::GetData() {
-    return data_;
-  }
+  const Node2D::Index Node2D::kNone;
 
 } //\ namespace path
@@ -37,6 +37,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 //
 // This is a helper class to do various operations on Point2D objects.
+// The Ptr versions defined here adapt to the inline value versions in
+// the header.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -56,16 +58,16 @@ namespace path {
     return point;
   }
 
+  Point2D::Ptr Point2D::Create(const Point2D::Value& point) {
+    return Create(point.x, point.y);
+  }
+
   // Midpoint.
   Point2D::Ptr Point2D::MidPoint(Point2D::Ptr point1, Point2D::Ptr point2) {
     CHECK_NOTNULL(point1.get());
     CHECK_NOTNULL(point2.get());
 
-    float mid_x = 0.5 * (point1->x + point2->x);
-    float mid_y = 0.5 * (point1->y + point2->y);
-
-    Point2D::Ptr midpoint = Create(mid_x, mid_y);
-    return midpoint;
+    return Create(MidPoint(Point2D::Value(*point1), Point2D::Value(*point2)));
   }
 
   // Distance between a the line segment between the first two points,
@@ -77,31 +79,9 @@ namespace path {
     CHECK_NOTNULL(point2.get());
     CHECK_NOTNULL(point3.get());
 
-    // Get vectors from point1 to point2 and from point1 to point3.
-    float direction_x = point2->x - point1->x;
-    float direction_y = point2->y - point1->y;
-    float direction_length = std::sqrt(direction_x * direction_x +
-                                       direction_y * direction_y);
-    direction_x /= direction_length;
-    direction_y /= direction_length;
-
-    float query_x = point3->x - point1->x;
-    float query_y = point3->y - point1->y;
-    float query_length = std::sqrt(query_x * query_x +
-                                   query_y * query_y);
-
-    // Test if point projects onto line segment.
-    float dot_product = direction_x * query_x + direction_y * query_y;
-    if (dot_product <= direction_length && dot_product >= 0.0) {
-      // Projects onto line segment.
-      return std::sqrt(query_length * query_length -
-                       dot_product * dot_product);
-    } else {
-      // Doesn't project onto the line segment.
-      float dist1 = DistancePointToPoint(point1, point3);
-      float dist2 = DistancePointToPoint(point2, point3);
-      return std::min(dist1, dist2);
-    }
+    return DistanceLineToPoint(Point2D::Value(*point1),
+                               Point2D::Value(*point2),
+                               Point2D::Value(*point3));
   }
 
   // Distance between two points.
@@ -110,9 +90,8 @@ namespace path {
     CHECK_NOTNULL(point1.get());
     CHECK_NOTNULL(point2.get());
 
-    float dx = point2->x - point1->x;
-    float dy = point2->y - point1->y;
-    return std::sqrt(dx * dx + dy * dy);
+    return DistancePointToPoint(Point2D::Value(*point1),
+                                Point2D::Value(*point2));
   }
 
   // Take a step toward point2 from point1.
@@ -122,13 +101,8 @@ namespace path {
     CHECK_NOTNULL(point1.get());
     CHECK_NOTNULL(point2.get());
 
-    float length = DistancePointToPoint(point1, point2);
-    if (step_size > length)
-      step_size = length;
-
-    float step_x = point1->x + step_size * (point2->x - point1->x) / length;
-    float step_y = point1->y + step_size * (point2->y - point1->y) / length;
-    return Create(step_x, step_y);
+    return Create(StepToward(Point2D::Value(*point1),
+                             Point2D::Value(*point2), step_size));
   }
 
   // Add two points with a scale factor.
@@ -138,9 +112,8 @@ namespace path {
     CHECK_NOTNULL(point1.get());
     CHECK_NOTNULL(point2.get());
 
-    float sum_x = point1->x + scale * point2->x;
-    float sum_y = point2->y + scale * point2->y;
-    return Create(sum_x, sum_y);
+    return Create(Add(Point2D::Value(*point1), Point2D::Value(*point2),
+                      scale));
   }
 
 } //\ namespace path
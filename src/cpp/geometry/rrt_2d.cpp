@@ -42,7 +42,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <geometry/rrt_2d.h>
-#include <list>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <glog/logging.h>
 
@@ -51,32 +52,26 @@ namespace path {
   // Insert a point. Returns true if successful.
   bool RRT2D::Insert(Point2D::Ptr point) {
     CHECK_NOTNULL(point.get());
+    return Insert(Point2D::Value(*point)) != Node2D::kNone;
+  }
 
+  Node2D::Index RRT2D::Insert(const Point2D::Value& point) {
     // Base case -- empty tree.
-    if (registry_.size() == 0) {
-      head_ = Node2D::Create(point);
-      registry_.emplace(point, head_);
-      kd_tree_.AddPoint(point);
-      return true;
-    }
-
-    // Don't insert if the tree already contains this point.
-    if (Contains(point)) return false;
+    if (nodes_.empty())
+      return AddNode(point, Node2D::kNone);
 
-    // Find nearest point.
-    Point2D::Ptr nearest = GetNearest(point);
-
-    // Make a new Node2D and insert.
-    Node2D::Ptr node = Node2D::Create(point);
-    Node2D::Ptr parent = registry_.at(nearest);
-    node->SetParent(parent);
-    parent->AddChild(node);
+    // Find nearest point. Don't insert if the tree already contains it.
+    Node2D::Index nearest = GetNearestIndex(point);
+    if (nearest == Node2D::kNone) {
+      VLOG(1) << "Did not find a nearest neighbor. Did not insert.";
+      return Node2D::kNone;
+    }
 
-    // Update the registry and add to the kdtree.
-    registry_.emplace(point, node);
-    kd_tree_.AddPoint(point);
+    const Point2D::Value& nearest_point = nodes_[nearest].point;
+    if (nearest_point.x == point.x && nearest_point.y == point.y)
+      return Node2D::kNone;
 
-    return true;
+    return AddNode(point, nearest);
   }
 
   // Insert a point at a specified node. Returns true if successful.
@@ -85,69 +80,225 @@ namespace path {
     CHECK_NOTNULL(parent.get());
 
     // Ensure parent exists.
-    if (!Contains(parent)) {
+    Node2D::Index parent_index = Find(Point2D::Value(*parent));
+    if (parent_index == Node2D::kNone) {
       VLOG(1) << "Specified parent does not exist. Did not insert.";
       return false;
     }
 
+    return Insert(Point2D::Value(*point), parent_index) != Node2D::kNone;
+  }
+
+  Node2D::Index RRT2D::Insert(const Point2D::Value& point,
+                              Node2D::Index parent) {
+    // Ensure parent exists.
+    if (parent >= nodes_.size() || kd_tree_.IsRemoved(parent)) {
+      VLOG(1) << "Specified parent does not exist. Did not insert.";
+      return Node2D::kNone;
+    }
+
     // Don't insert if the tree already contains this point.
-    if (Contains(point)) return false;
+    if (Contains(point)) return Node2D::kNone;
+
+    return AddNode(point, parent);
+  }
 
-    // Make a new Node2D and insert.
-    Node2D::Ptr node = Node2D::Create(point);
-    Node2D::Ptr parent_node = registry_.at(parent);
-    node->SetParent(parent_node);
-    parent_node->AddChild(node);
+  // Insert nodes along a straight line.
+  Node2D::Index RRT2D::InsertSegment(Node2D::Index index,
+                                     const Point2D::Value& target,
+                                     float step_size) {
+    CHECK_GT(step_size, 0.0);
+    Point2D::Value step = GetPoint(index);
 
-    // Update the registry and add to the kdtree.
-    registry_.emplace(point, node);
-    kd_tree_.AddPoint(point);
+    const float distance = Point2D::DistancePointToPoint(step, target);
+    const int num_steps = static_cast<int>(std::ceil(distance / step_size));
+    for (int ii = 0; ii < num_steps - 1; ii++) {
+      const Point2D::Value next =
+        Point2D::StepToward(step, target, step_size);
+      const Node2D::Index next_index = Insert(next, index);
+      if (next_index == Node2D::kNone) {
+        VLOG(1) << "Error. Could not insert a point.";
+        return Node2D::kNone;
+      }
 
-    return true;
+      step = next;
+      index = next_index;
+    }
+
+    return Insert(target, index);
   }
 
   // Does the tree contain this point?
   bool RRT2D::Contains(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
-    return registry_.count(point) > 0;
+    return Contains(Point2D::Value(*point));
+  }
+
+  bool RRT2D::Contains(const Point2D::Value& point) const {
+    return Find(point) != Node2D::kNone;
+  }
+
+  // Index of the node at this point, or Node2D::kNone.
+  Node2D::Index RRT2D::Find(const Point2D::Value& point) const {
+    Node2D::Index nearest = GetNearestIndex(point);
+    if (nearest == Node2D::kNone)
+      return Node2D::kNone;
+
+    const Point2D::Value& nearest_point = nodes_[nearest].point;
+    if (nearest_point.x != point.x || nearest_point.y != point.y)
+      return Node2D::kNone;
+
+    return nearest;
   }
 
   // Tree size.
   int RRT2D::Size() const {
-    return static_cast<int>(kd_tree_.Size());
+    return static_cast<int>(nodes_.size());
   }
 
   // Get nearest point in the tree.
   Point2D::Ptr RRT2D::GetNearest(Point2D::Ptr point) {
     CHECK_NOTNULL(point.get());
+    return GetNearest(Point2D::Value(*point));
+  }
 
-    Point2D::Ptr nearest;
+  Point2D::Ptr RRT2D::GetNearest(const Point2D::Value& point) {
+    Node2D::Index nearest = GetNearestIndex(point);
+    if (nearest == Node2D::kNone)
+      return Point2D::Ptr(nullptr);
+
+    return Point2D::Create(nodes_[nearest].point);
+  }
+
+  Node2D::Index RRT2D::GetNearestIndex(const Point2D::Value& point) const {
+    int nearest = -1;
     float distance;
-    if (!kd_tree_.NearestNeighbor(point, nearest, distance))
+    if (!kd_tree_.NearestNeighbor(point, nearest, distance)) {
       VLOG(1) << "Did not find a nearest neighbor.";
-    return nearest;
+      return Node2D::kNone;
+    }
+
+    return static_cast<Node2D::Index>(nearest);
+  }
+
+  // Indices of all nodes within a radius.
+  void RRT2D::RadiusSearch(const Point2D::Value& point, float radius,
+                           std::vector<Node2D::Index>& neighbors) const {
+    neighbors.clear();
+    kd_tree_.RadiusVisit(point, radius, [&](int index) {
+        neighbors.push_back(static_cast<Node2D::Index>(index));
+      });
+  }
+
+  // Move a node under a new parent.
+  void RRT2D::SetParent(Node2D::Index index, Node2D::Index parent) {
+    CHECK_LT(index, nodes_.size());
+    CHECK_LT(parent, nodes_.size());
+    CHECK_NE(index, parent);
+
+    if (nodes_[index].parent == parent)
+      return;
+
+    Unlink(index);
+    Link(index, parent);
+  }
+
+  // Detach a node and hide it from queries.
+  void RRT2D::Remove(Node2D::Index index) {
+    CHECK_LT(index, nodes_.size());
+    if (kd_tree_.IsRemoved(index))
+      return;
+
+    Unlink(index);
+    nodes_[index].parent = Node2D::kNone;
+    kd_tree_.Remove(index);
+  }
+
+  // Restore a removed node under a live parent.
+  void RRT2D::Restore(Node2D::Index index, Node2D::Index parent) {
+    CHECK_LT(index, nodes_.size());
+    CHECK_LT(parent, nodes_.size());
+    CHECK(kd_tree_.IsRemoved(index));
+    CHECK(!kd_tree_.IsRemoved(parent));
+
+    kd_tree_.Restore(index);
+    Link(index, parent);
+  }
+
+  bool RRT2D::IsRemoved(Node2D::Index index) const {
+    CHECK_LT(index, nodes_.size());
+    return kd_tree_.IsRemoved(index);
   }
 
   // Get the path from the head to a particular goal point.
   Trajectory2D::Ptr RRT2D::GetTrajectory(Point2D::Ptr goal) {
+    CHECK_NOTNULL(goal.get());
+    return GetTrajectory(Find(Point2D::Value(*goal)));
+  }
+
+  Trajectory2D::Ptr RRT2D::GetTrajectory(Node2D::Index goal) const {
 
     // Return empty path if goal is not in the tree.
-    if (!Contains(goal)) {
+    if (goal >= nodes_.size()) {
       VLOG(1) << "Tree does not contain the goal point. Returning "
               << "nullptr.";
       return Trajectory2D::Ptr(nullptr);
     }
 
-    // Trace the tree and populate the path.
-    std::list<Point2D::Ptr> trace;
-    Node2D::Ptr current_node = registry_.at(goal);
-    while (current_node) {
-      trace.push_front(current_node->GetData());
-      current_node = current_node->GetParent();
+    // Trace the tree from the goal back to the head, then reverse.
+    std::vector<float> x, y;
+    for (Node2D::Index ii = goal; ii != Node2D::kNone; ii = nodes_[ii].parent) {
+      x.push_back(nodes_[ii].point.x);
+      y.push_back(nodes_[ii].point.y);
     }
 
-    Trajectory2D::Ptr path = Trajectory2D::Create(trace);
-    return path;
+    std::reverse(x.begin(), x.end());
+    std::reverse(y.begin(), y.end());
+    return Trajectory2D::Create(x, y);
+  }
+
+  // Node accessors.
+  const Node2D& RRT2D::GetNode(Node2D::Index index) const {
+    CHECK_LT(index, nodes_.size());
+    return nodes_[index];
+  }
+
+  const Point2D::Value& RRT2D::GetPoint(Node2D::Index index) const {
+    return GetNode(index).point;
+  }
+
+  // Append a node to the arena and the kd tree.
+  Node2D::Index RRT2D::AddNode(const Point2D::Value& point,
+                               Node2D::Index parent) {
+    CHECK_LT(nodes_.size(), static_cast<size_t>(Node2D::kNone));
+
+    const Node2D::Index index = static_cast<Node2D::Index>(nodes_.size());
+    nodes_.push_back(Node2D(point, Node2D::kNone));
+    if (parent != Node2D::kNone)
+      Link(index, parent);
+
+    kd_tree_.AddPoint(point);
+    return index;
+  }
+
+  // Add a node to the front of a parent's list of children.
+  void RRT2D::Link(Node2D::Index index, Node2D::Index parent) {
+    nodes_[index].parent = parent;
+    nodes_[index].next_sibling = nodes_[parent].first_child;
+    nodes_[parent].first_child = index;
+  }
+
+  // Take a node out of its parent's list of children.
+  void RRT2D::Unlink(Node2D::Index index) {
+    Node2D& node = nodes_[index];
+    if (node.parent == Node2D::kNone)
+      return;
+
+    Node2D::Index* link = &nodes_[node.parent].first_child;
+    while (*link != index)
+      link = &nodes_[*link].next_sibling;
+    *link = node.next_sibling;
+    node.next_sibling = Node2D::kNone;
   }
 
 } //\ namespace path
@@ -46,10 +46,43 @@
 #include <geometry/point_2d.h>
 #include <glog/logging.h>
 #include <iostream>
+#include <cmath>
 
 
 namespace path {
 
+  namespace {
+
+    // Total length of the polyline through 'count' points. Segment lengths
+    // are accumulated into independent lanes so that the loop vectorizes.
+    double PolylineLength(const float* x, const float* y, size_t count) {
+      const size_t kNumLanes = 8;
+      double lanes[kNumLanes] = { 0.0 };
+
+      size_t ii = 1;
+      for (; ii + kNumLanes <= count; ii += kNumLanes) {
+        for (size_t kk = 0; kk < kNumLanes; kk++) {
+          float dx = x[ii + kk] - x[ii + kk - 1];
+          float dy = y[ii + kk] - y[ii + kk - 1];
+          lanes[kk] += std::sqrt(dx * dx + dy * dy);
+        }
+      }
+
+      double length = 0.0;
+      for (; ii < count; ii++) {
+        float dx = x[ii] - x[ii - 1];
+        float dy = y[ii] - y[ii - 1];
+        length += std::sqrt(dx * dx + dy * dy);
+      }
+
+      for (size_t kk = 0; kk < kNumLanes; kk++)
+        length += lanes[kk];
+
+      return length;
+    }
+
+  } //\ namespace
+
   // Factory methods.
   Trajectory2D::Ptr Trajectory2D::Create() {
     Trajectory2D::Ptr path(new Trajectory2D());
@@ -66,172 +99,230 @@ namespace path {
     return path;
   }
 
+  Trajectory2D::Ptr Trajectory2D::Create(
+                             const std::vector<Point2D::Value>& points) {
+    Trajectory2D::Ptr path(new Trajectory2D(points));
+    return path;
+  }
+
+  Trajectory2D::Ptr Trajectory2D::Create(const std::vector<float>& x,
+                                         const std::vector<float>& y) {
+    Trajectory2D::Ptr path(new Trajectory2D(x, y));
+    return path;
+  }
+
   // A Trajectory2D is just an ordered list of Points.
   Trajectory2D::Trajectory2D()
     : length_(0.0) {}
 
   // Initialize with a set of points.
   Trajectory2D::Trajectory2D(std::vector<Point2D::Ptr>& points) {
-    length_ = 0.0;
+    x_.reserve(points.size());
+    y_.reserve(points.size());
+    for (const auto& point : points) {
+      CHECK_NOTNULL(point.get());
+      x_.push_back(point->x);
+      y_.push_back(point->y);
+    }
 
-    // Iterate through points, compute distances, and add to path.
-    for (size_t ii = 0; ii < points.size(); ii++) {
-      Point2D::Ptr next_point = points[ii];
-      points_.push_back(next_point);
+    RecomputeLength();
+  }
 
-      if (ii > 0) {
-        Point2D::Ptr last_point = points[ii - 1];
-        length_ += Point2D::DistancePointToPoint(last_point, next_point);
-      }
+  // Initialize with a set of points.
+  Trajectory2D::Trajectory2D(std::list<Point2D::Ptr>& points) {
+    x_.reserve(points.size());
+    y_.reserve(points.size());
+    for (const auto& point : points) {
+      CHECK_NOTNULL(point.get());
+      x_.push_back(point->x);
+      y_.push_back(point->y);
     }
+
+    RecomputeLength();
   }
 
   // Initialize with a set of points.
-  Trajectory2D::Trajectory2D(std::list<Point2D::Ptr>& points) {
-    length_ = 0.0;
-
-    // Iterate through points, compute distances, and add to path.
-    Point2D::Ptr last_point = points.front();
-    for (const auto& next_point : points) {
-      points_.push_back(next_point);
-      length_ += Point2D::DistancePointToPoint(last_point, next_point);
-      last_point = next_point;
+  Trajectory2D::Trajectory2D(const std::vector<Point2D::Value>& points) {
+    x_.reserve(points.size());
+    y_.reserve(points.size());
+    for (const auto& point : points) {
+      x_.push_back(point.x);
+      y_.push_back(point.y);
     }
+
+    RecomputeLength();
+  }
+
+  // Initialize with coordinate arrays.
+  Trajectory2D::Trajectory2D(const std::vector<float>& x,
+                             const std::vector<float>& y)
+    : x_(x), y_(y) {
+    CHECK_EQ(x_.size(), y_.size());
+    RecomputeLength();
   }
 
   // Recompute length.
   void Trajectory2D::RecomputeLength() {
-    length_ = 0.0;
-
-    for (size_t ii = 0; ii < points_.size() - 1; ii++)
-      length_ += Point2D::DistancePointToPoint(points_[ii],
-                                               points_[ii + 1]);
+    length_ = PolylineLength(x_.data(), y_.data(), x_.size());
   }
 
   // Add a point to the path.
   void Trajectory2D::AddPoint(Point2D::Ptr point) {
     CHECK_NOTNULL(point.get());
+    AddPoint(Point2D::Value(*point));
+  }
 
-    if (points_.size() > 0) {
-      Point2D::Ptr last_point = points_.back();
-      length_ += Point2D::DistancePointToPoint(last_point, point);
-    }
+  void Trajectory2D::AddPoint(const Point2D::Value& point) {
+    if (x_.size() > 0)
+      length_ += Point2D::DistancePointToPoint(GetValueAt(x_.size() - 1),
+                                               point);
 
-    points_.push_back(point);
+    x_.push_back(point.x);
+    y_.push_back(point.y);
   }
 
   // Upsample by adding k points linearly between each pair of points
   // in this Trajectory2D.
   void Trajectory2D::Upsample(unsigned int k) {
-    std::vector<Point2D::Ptr> old_points(points_);
-    points_.clear();
-
-    for (size_t ii = 0; ii < old_points.size() - 1; ii++) {
-      Point2D::Ptr current_point = old_points[ii];
-      Point2D::Ptr next_point = old_points[ii + 1];
-      double length = Point2D::DistancePointToPoint(current_point,
-                                                    next_point);
-      double step_size = length / static_cast<double>(k + 1);
-
-      points_.push_back(current_point);
-      for (unsigned int jj = 1; jj <= k; jj++) {
-        Point2D::Ptr step =
-          Point2D::StepToward(current_point, next_point,
-                              static_cast<double>(jj) * step_size);
-        points_.push_back(step);
-      }
+    const size_t num_points = x_.size();
+    if (num_points < 2 || k == 0)
+      return;
 
-      // Make sure to push back final point.
-      if (ii == old_points.size() - 1)
-        points_.push_back(next_point);
+    // Point jj of segment ii lands at index ii * (k + 1) + jj.
+    const size_t stride = k + 1;
+    std::vector<float> x((num_points - 1) * stride + 1);
+    std::vector<float> y(x.size());
+
+    for (size_t ii = 0; ii < num_points - 1; ii++) {
+      const float dx = x_[ii + 1] - x_[ii];
+      const float dy = y_[ii + 1] - y_[ii];
+      float* segment_x = &x[ii * stride];
+      float* segment_y = &y[ii * stride];
+
+      for (unsigned int jj = 0; jj < stride; jj++) {
+        const float fraction =
+          static_cast<float>(jj) / static_cast<float>(stride);
+        segment_x[jj] = x_[ii] + fraction * dx;
+        segment_y[jj] = y_[ii] + fraction * dy;
+      }
     }
+
+    // Make sure to push back final point.
+    x.back() = x_.back();
+    y.back() = y_.back();
+
+    x_.swap(x);
+    y_.swap(y);
   }
 
   // Compute the first derivative of the path in time using a 1D symmetric
   // difference filter, assuming uniform (time) sampling. Calculate at the
   // endpoints with forward/backward differences.
-  Trajectory2D::Ptr Trajectory2D::TimeDerivative() {
+  Trajectory2D::Ptr Trajectory2D::TimeDerivative() const {
     Trajectory2D::Ptr derivative = Trajectory2D::Create();
+    TimeDerivative(*derivative);
+    return derivative;
+  }
+
+  void Trajectory2D::TimeDerivative(Trajectory2D& derivative) const {
+    CHECK_NE(&derivative, this);
 
     // Handle corner cases: size 0/1.
-    if (points_.size() == 0) {
+    if (x_.size() == 0) {
       VLOG(1) << "Caution! Tried to evaluate the derivative "
               << "of an empty Trajectory2D.";
-      return derivative;
-    }
-
-    Point2D::Ptr zero = Point2D::Create(0.0, 0.0);
-    if (points_.size() == 1) {
+    } else if (x_.size() == 1) {
       VLOG(1) << "Caution! Tried to evaluate the derivative "
               << "of a Trajectory2D with only a single element.";
-      derivative->AddPoint(zero);
-      return derivative;
     }
 
-    // Handle the first point.
-    Point2D::Ptr diff = Point2D::Add(points_[1], points_[0], -1.0);
-    derivative->AddPoint(diff);
+    derivative.x_.resize(x_.size());
+    derivative.y_.resize(y_.size());
+    TimeDerivative(x_.data(), x_.size(), derivative.x_.data());
+    TimeDerivative(y_.data(), y_.size(), derivative.y_.data());
+    derivative.RecomputeLength();
+  }
 
-    // Handle middle points. Remember to divide by two for symmetric differences.
-    for (size_t ii = 1; ii < points_.size() - 1; ii++) {
-      diff = Point2D::Add(points_[ii + 1], points_[ii - 1], -1.0);
-      derivative->AddPoint(Point2D::Add(zero, diff, 0.5));
+  void Trajectory2D::TimeDerivative(const float* in, size_t count,
+                                    float* out) {
+    if (count == 0)
+      return;
+
+    if (count == 1) {
+      out[0] = 0.0;
+      return;
     }
 
-    // Handle the last point.
-    diff = Point2D::Add(points_[points_.size() - 1],
-                               points_[points_.size() - 2], -1.0);
-    derivative->AddPoint(diff);
+    // Handle middle points. Remember to divide by two for symmetric differences.
+    for (size_t ii = 1; ii < count - 1; ii++)
+      out[ii] = 0.5 * (in[ii + 1] - in[ii - 1]);
 
-    return derivative;
+    // Handle the endpoints.
+    out[0] = in[1] - in[0];
+    out[count - 1] = in[count - 1] - in[count - 2];
   }
 
   // Getters.
   double Trajectory2D::GetLength() const { return length_; }
-  std::vector<Point2D::Ptr>& Trajectory2D::GetPoints() { return points_; }
-  Point2D::Ptr Trajectory2D::GetAt(size_t index) {
+  size_t Trajectory2D::Size() const { return x_.size(); }
+
+  std::vector<Point2D::Ptr> Trajectory2D::GetPoints() const {
+    std::vector<Point2D::Ptr> points;
+    points.reserve(x_.size());
+    for (size_t ii = 0; ii < x_.size(); ii++)
+      points.push_back(Point2D::Create(x_[ii], y_[ii]));
+
+    return points;
+  }
+
+  Point2D::Ptr Trajectory2D::GetAt(size_t index) const {
     // Check index.
-    if (index >= points_.size()) {
+    if (index >= x_.size()) {
       LOG(ERROR) << "Index is out of bounds. Returning a nullptr.";
       return nullptr;
     }
 
-    return points_[index];
+    return Point2D::Create(x_[index], y_[index]);
+  }
+
+  Point2D::Value Trajectory2D::GetValueAt(size_t index) const {
+    CHECK_LT(index, x_.size());
+    return Point2D::Value(x_[index], y_[index]);
   }
 
+  const float* Trajectory2D::GetX() const { return x_.data(); }
+  const float* Trajectory2D::GetY() const { return y_.data(); }
+  float* Trajectory2D::GetMutableX() { return x_.data(); }
+  float* Trajectory2D::GetMutableY() { return y_.data(); }
+
   // Setter.
   void Trajectory2D::SetAt(Point2D::Ptr point, size_t index) {
+    CHECK_NOTNULL(point.get());
+    SetAt(Point2D::Value(*point), index);
+  }
+
+  void Trajectory2D::SetAt(const Point2D::Value& point, size_t index) {
     // Check index.
-    if (index >= points_.size()) {
+    if (index >= x_.size()) {
       VLOG(1) << "Index is out of bounds. Did not replace.";
       return;
     }
 
-    // Replace and adjust length_ case-by-case.
-    if (index == 0 && points_.size() == 1)
-      points_[0] = point;
-    else if (index == 0 && points_.size() >= 2) {
-      length_ -= Point2D::DistancePointToPoint(points_[0],
-                                               points_[1]);
-      length_ += Point2D::DistancePointToPoint(point,
-                                               points_[1]);
-      points_[0] = point;
-    } else if (index == points_.size() - 1) {
-      length_ -= Point2D::DistancePointToPoint(points_[index],
-                                               points_[index - 1]);
-      length_ += Point2D::DistancePointToPoint(point,
-                                               points_[index - 1]);
-      points_[index] = point;
-    } else {
-      length_ -= Point2D::DistancePointToPoint(points_[index],
-                                               points_[index - 1]);
-      length_ -= Point2D::DistancePointToPoint(points_[index],
-                                               points_[index + 1]);
-      length_ += Point2D::DistancePointToPoint(point,
-                                               points_[index - 1]);
-      length_ += Point2D::DistancePointToPoint(point,
-                                               points_[index + 1]);
-      points_[index] = point;
+    // Adjust length_ for the segments on either side of this point.
+    const Point2D::Value old_point = GetValueAt(index);
+    if (index > 0) {
+      const Point2D::Value previous = GetValueAt(index - 1);
+      length_ -= Point2D::DistancePointToPoint(old_point, previous);
+      length_ += Point2D::DistancePointToPoint(point, previous);
     }
+
+    if (index + 1 < x_.size()) {
+      const Point2D::Value next = GetValueAt(index + 1);
+      length_ -= Point2D::DistancePointToPoint(old_point, next);
+      length_ += Point2D::DistancePointToPoint(point, next);
+    }
+
+    x_[index] = point.x;
+    y_[index] = point.y;
   }
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+#include <math/banded_cholesky.h>
+
+#include <algorithm>
+#include <cmath>
+#include <glog/logging.h>
+
+namespace path {
+namespace math {
+
+BandedCholesky::BandedCholesky(size_t size, size_t bandwidth)
+    : size_(size),
+      bandwidth_(bandwidth),
+      band_(size * (bandwidth + 1), 0.0),
+      factorized_(false) {}
+
+void BandedCholesky::Set(size_t row, size_t col, double value) {
+  if (col > row)
+    std::swap(row, col);
+  CHECK_LT(row, size_);
+  CHECK_LE(row - col, bandwidth_);
+  At(row, col) = value;
+  factorized_ = false;
+}
+
+bool BandedCholesky::Factorize() {
+  for (size_t ii = 0; ii < size_; ii++) {
+    const size_t first = (ii > bandwidth_) ? ii - bandwidth_ : 0;
+
+    for (size_t jj = first; jj <= ii; jj++) {
+      // Only columns within the band of both rows contribute.
+      double sum = At(ii, jj);
+      for (size_t kk = std::max(first, (jj > bandwidth_) ? jj - bandwidth_ : 0);
+           kk < jj; kk++)
+        sum -= At(ii, kk) * At(jj, kk);
+
+      if (jj < ii) {
+        At(ii, jj) = sum / At(jj, jj);
+      } else {
+        if (sum <= 0.0)
+          return false;
+        At(ii, ii) = std::sqrt(sum);
+      }
+    }
+  }
+
+  factorized_ = true;
+  return true;
+}
+
+void BandedCholesky::Solve(double* b) const {
+  CHECK(factorized_);
+  CHECK_NOTNULL(b);
+
+  // Forward substitution, L y = b.
+  for (size_t ii = 0; ii < size_; ii++) {
+    const size_t first = (ii > bandwidth_) ? ii - bandwidth_ : 0;
+    for (size_t kk = first; kk < ii; kk++)
+      b[ii] -= At(ii, kk) * b[kk];
+    b[ii] /= At(ii, ii);
+  }
+
+  // Back substitution, L' x = y.
+  for (size_t ii = size_; ii-- > 0; ) {
+    const size_t last = std::min(size_ - 1, ii + bandwidth_);
+    for (size_t kk = ii + 1; kk <= last; kk++)
+      b[ii] -= At(kk, ii) * b[kk];
+    b[ii] /= At(ii, ii);
+  }
+}
+
+}  //\namespace math
+}  //\namespace path
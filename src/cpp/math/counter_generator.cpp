@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+#include <math/counter_generator.h>
+
+#include <glog/logging.h>
+
+namespace path {
+namespace math {
+
+namespace {
+
+// Philox4x32 multipliers and Weyl key increments.
+const uint32_t kMultiplier0 = 0xD2511F53;
+const uint32_t kMultiplier1 = 0xCD9E8D57;
+const uint32_t kWeyl0 = 0x9E3779B9;
+const uint32_t kWeyl1 = 0xBB67AE85;
+const int kRounds = 10;
+
+// The top 53 bits of a 64-bit word, scaled by 2^-53.
+inline double ToDouble(uint32_t high, uint32_t low) {
+  const uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+  return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}  //\namespace
+
+void CounterGenerator::Philox(const uint32_t counter[4], const uint32_t key[2],
+                              uint32_t block[4]) {
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key[0], k1 = key[1];
+
+  for (int round = 0; round < kRounds; ++round) {
+    const uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * c0;
+    const uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * c2;
+    const uint32_t high0 = static_cast<uint32_t>(product0 >> 32);
+    const uint32_t high1 = static_cast<uint32_t>(product1 >> 32);
+
+    c0 = high1 ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(product1);
+    c2 = high0 ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(product0);
+
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+
+  block[0] = c0;
+  block[1] = c1;
+  block[2] = c2;
+  block[3] = c3;
+}
+
+void CounterGenerator::Block(uint64_t stream, uint64_t index,
+                             uint32_t block[4]) const {
+  const uint32_t counter[4] = {
+    static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+    static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) };
+  const uint32_t key[2] = {
+    static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32) };
+  Philox(counter, key, block);
+}
+
+void CounterGenerator::DoublePair(uint64_t stream, uint64_t index,
+                                  double* first, double* second) const {
+  CHECK_NOTNULL(first);
+  CHECK_NOTNULL(second);
+
+  uint32_t block[4];
+  Block(stream, index, block);
+  *first = ToDouble(block[0], block[1]);
+  *second = ToDouble(block[2], block[3]);
+}
+
+double CounterGenerator::Double(uint64_t stream, uint64_t index) const {
+  uint32_t block[4];
+  Block(stream, index, block);
+  return ToDouble(block[0], block[1]);
+}
+
+double CounterGenerator::DoubleUniform(uint64_t stream, uint64_t index,
+                                       double min, double max) const {
+  return min + (max - min) * Double(stream, index);
+}
+
+void CounterGenerator::DoublesUniform(uint64_t stream, uint64_t first_index,
+                                      size_t count, double min, double max,
+                                      std::vector<double>* doubles) const {
+  if (doubles == nullptr) {
+    return;
+  }
+
+  const size_t offset = doubles->size();
+  doubles->resize(offset + count);
+  for (size_t i = 0; i < count; ++i) {
+    (*doubles)[offset + i] = DoubleUniform(stream, first_index + i, min, max);
+  }
+}
+
+}  //\namespace math
+}  //\namespace path
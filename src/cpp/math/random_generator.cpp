@@ -37,15 +37,88 @@
 
 #include <math/random_generator.h>
 
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace path {
 namespace math {
 
+namespace {
+
+inline uint64_t Rotate(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+// SplitMix64, used to expand a seed into generator state:
+// http://prng.di.unimi.it/splitmix64.c
+inline uint64_t SplitMix(uint64_t& x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// One xoshiro256** step on state (s0, s1, s2, s3). The multiplications by
+// 5 and 9 are written as shifts and adds, to match the AVX2 version below.
+inline uint64_t Step(uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3) {
+  const uint64_t rotated = Rotate((s1 << 2) + s1, 7);
+  const uint64_t result = (rotated << 3) + rotated;
+  const uint64_t t = s1 << 17;
+  s2 ^= s0;
+  s3 ^= s1;
+  s1 ^= s2;
+  s0 ^= s3;
+  s2 ^= t;
+  s3 = Rotate(s3, 45);
+  return result;
+}
+
+#ifdef __AVX2__
+template <int k>
+inline __m256i Rotate(__m256i x) {
+  return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+// Four xoshiro256** steps at once, one per 64-bit lane.
+inline __m256i Step(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3) {
+  const __m256i rotated =
+    Rotate<7>(_mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1));
+  const __m256i result =
+    _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+  const __m256i t = _mm256_slli_epi64(s1, 17);
+  s2 = _mm256_xor_si256(s2, s0);
+  s3 = _mm256_xor_si256(s3, s1);
+  s1 = _mm256_xor_si256(s1, s2);
+  s0 = _mm256_xor_si256(s0, s3);
+  s2 = _mm256_xor_si256(s2, t);
+  s3 = Rotate<45>(s3);
+  return result;
+}
+#endif
+
+}  //\namespace
+
+const size_t RandomGenerator::kLanes;
+const size_t RandomGenerator::kBlockSize;
+
 RandomGenerator::RandomGenerator(unsigned long seed) {
-  srand(seed);
+  SetSeed(seed);
+  SeedLanes();
 }
 
 RandomGenerator::RandomGenerator() {
-  srand(Seed());
+  SetSeed(Seed());
+  SeedLanes();
+}
+
+RandomGenerator::RandomGenerator(unsigned long seed, unsigned long stream) {
+  SetSeed(seed);
+  for (unsigned long ii = 0; ii < stream; ++ii)
+    Jump();
+  SeedLanes();
 }
 
 unsigned long RandomGenerator::Seed() {
@@ -60,33 +133,125 @@ unsigned long RandomGenerator::Seed() {
   return c;
 }
 
+void RandomGenerator::SetSeed(unsigned long seed) {
+  uint64_t x = seed;
+  for (int ii = 0; ii < 4; ++ii)
+    state_[ii] = SplitMix(x);
+}
+
+void RandomGenerator::SeedLanes() {
+  // Lanes start from a hash of this generator's next output, so they depend
+  // on the seed and stream without overlapping the main sequence.
+  uint64_t x = Next();
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    for (int ii = 0; ii < 4; ++ii)
+      lanes_[ii][lane] = SplitMix(x);
+  }
+}
+
+// Jump polynomial from http://prng.di.unimi.it/xoshiro256starstar.c
+void RandomGenerator::Jump() {
+  static const uint64_t kJump[] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+  uint64_t jumped[4] = { 0, 0, 0, 0 };
+  for (int ii = 0; ii < 4; ++ii) {
+    for (int bit = 0; bit < 64; ++bit) {
+      if (kJump[ii] & (1ULL << bit)) {
+        for (int jj = 0; jj < 4; ++jj)
+          jumped[jj] ^= state_[jj];
+      }
+      Next();
+    }
+  }
+
+  std::copy(jumped, jumped + 4, state_);
+}
+
+uint64_t RandomGenerator::Next() const {
+  return Step(state_[0], state_[1], state_[2], state_[3]);
+}
+
+void RandomGenerator::NextLanes(size_t count, uint64_t* values) const {
+  size_t ii = 0;
+
+#ifdef __AVX2__
+  // Eight lanes are two vectors of four.
+  __m256i* lanes = reinterpret_cast<__m256i*>(lanes_);
+  __m256i s0a = _mm256_loadu_si256(lanes + 0), s0b = _mm256_loadu_si256(lanes + 1);
+  __m256i s1a = _mm256_loadu_si256(lanes + 2), s1b = _mm256_loadu_si256(lanes + 3);
+  __m256i s2a = _mm256_loadu_si256(lanes + 4), s2b = _mm256_loadu_si256(lanes + 5);
+  __m256i s3a = _mm256_loadu_si256(lanes + 6), s3b = _mm256_loadu_si256(lanes + 7);
+
+  for (; ii + kLanes <= count; ii += kLanes) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + ii),
+                        Step(s0a, s1a, s2a, s3a));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + ii + 4),
+                        Step(s0b, s1b, s2b, s3b));
+  }
+
+  _mm256_storeu_si256(lanes + 0, s0a);
+  _mm256_storeu_si256(lanes + 1, s0b);
+  _mm256_storeu_si256(lanes + 2, s1a);
+  _mm256_storeu_si256(lanes + 3, s1b);
+  _mm256_storeu_si256(lanes + 4, s2a);
+  _mm256_storeu_si256(lanes + 5, s2b);
+  _mm256_storeu_si256(lanes + 6, s3a);
+  _mm256_storeu_si256(lanes + 7, s3b);
+#else
+  for (; ii + kLanes <= count; ii += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      values[ii + lane] = Step(lanes_[0][lane], lanes_[1][lane],
+                               lanes_[2][lane], lanes_[3][lane]);
+    }
+  }
+#endif
+
+  // Remainder, one lane at a time.
+  for (size_t lane = 0; ii < count; ++ii, ++lane) {
+    values[ii] = Step(lanes_[0][lane], lanes_[1][lane],
+                      lanes_[2][lane], lanes_[3][lane]);
+  }
+}
+
+uint32_t RandomGenerator::Bounded(uint64_t bits, uint64_t range) {
+  // Multiply-shift: https://arxiv.org/abs/1805.10941
+  return static_cast<uint32_t>(((bits >> 32) * range) >> 32);
+}
+
+double RandomGenerator::ToDouble(uint64_t bits) {
+  // The top 53 bits, scaled by 2^-53.
+  return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
 
 int RandomGenerator::Integer() const {
-  // TODO(eanelson: Use a threadsafe rng.
-  return rand();
+  return static_cast<int>(Bounded(Next(), RAND_MAX));
 }
 
-// Generates a random integer in [0, 'max').
+// Generates a random integer in [0, 'max'].
 int RandomGenerator::IntegerUniform(int max) const {
   if (max <= 0) {
     LOG(WARNING) << "max <= 0. Returning 0.";
     // Eat a random number anyways and return 0.
-    Integer();
+    Next();
     return 0;
   }
 
-  return Integer() % static_cast<int>(max + 1);
+  return static_cast<int>(Bounded(Next(), static_cast<uint64_t>(max) + 1));
 }
 
 int RandomGenerator::IntegerUniform(int min, int max) const {
   if (min >= max) {
     LOG(WARNING) << "min >= max. Returning min.";
     // Eat a random number anyways and return min.
-    Integer();
+    Next();
     return min;
   }
 
-  return min + (Integer() % static_cast<int>(max - min + 1));
+  const uint64_t range = static_cast<uint64_t>(
+    static_cast<int64_t>(max) - static_cast<int64_t>(min)) + 1;
+  return static_cast<int>(static_cast<int64_t>(min) + Bounded(Next(), range));
 }
 
 void RandomGenerator::Integers(size_t count, std::vector<int> *integers) const {
@@ -94,8 +259,17 @@ void RandomGenerator::Integers(size_t count, std::vector<int> *integers) const {
     return;
   }
 
-  for (size_t i = 0; i < count; ++i) {
-    integers->push_back(Integer());
+  const size_t offset = integers->size();
+  integers->resize(offset + count);
+  int* values = integers->data() + offset;
+
+  uint64_t bits[kBlockSize];
+  for (size_t begin = 0; begin < count; begin += kBlockSize) {
+    const size_t block = std::min(kBlockSize, count - begin);
+    NextLanes(block, bits);
+    for (size_t i = 0; i < block; ++i) {
+      values[begin + i] = static_cast<int>(Bounded(bits[i], RAND_MAX));
+    }
   }
 }
 
@@ -105,25 +279,42 @@ void RandomGenerator::IntegersUniform(size_t count, int min, int max,
     return;
   }
 
-  for (size_t i = 0; i < count; ++i) {
-    integers->push_back(IntegerUniform(min, max));
+  if (min >= max) {
+    LOG(WARNING) << "min >= max. Returning min.";
+    integers->resize(integers->size() + count, min);
+    return;
+  }
+
+  const uint64_t range = static_cast<uint64_t>(
+    static_cast<int64_t>(max) - static_cast<int64_t>(min)) + 1;
+  const size_t offset = integers->size();
+  integers->resize(offset + count);
+  int* values = integers->data() + offset;
+
+  uint64_t bits[kBlockSize];
+  for (size_t begin = 0; begin < count; begin += kBlockSize) {
+    const size_t block = std::min(kBlockSize, count - begin);
+    NextLanes(block, bits);
+    for (size_t i = 0; i < block; ++i) {
+      values[begin + i] = static_cast<int>(static_cast<int64_t>(min) +
+                                           Bounded(bits[i], range));
+    }
   }
 }
 
 double RandomGenerator::Double() const {
-  return static_cast<double>(Integer()) / static_cast<double>(RAND_MAX);
+  return ToDouble(Next());
 }
 
 double RandomGenerator::DoubleUniform(double min, double max) const {
     if (min >= max) {
       LOG(WARNING) << "min >= max. Returning min.";
       // Eat a random number anyways and return min.
-      Integer();
+      Next();
       return min;
     }
 
-    double coefficient = (max - min) / static_cast<double>(RAND_MAX);
-    return min + static_cast<double>(Integer()) * coefficient;
+    return min + (max - min) * Double();
 }
 
 double RandomGenerator::DoubleGaussian(double mean, double stddev) const {
@@ -138,13 +329,7 @@ double RandomGenerator::DoubleGaussian(double mean, double stddev) const {
 }
 
 void RandomGenerator::Doubles(size_t count, std::vector<double>* doubles) const {
-  if (doubles == nullptr) {
-    return;
-  }
-
-  for (size_t i = 0; i < count; ++i) {
-    doubles->push_back(Double());
-  }
+  DoublesUniform(count, 0.0, 1.0, doubles);
 }
 
 void RandomGenerator::DoublesUniform(size_t count, double min, double max,
@@ -153,8 +338,24 @@ void RandomGenerator::DoublesUniform(size_t count, double min, double max,
     return;
   }
 
-  for (size_t i = 0; i < count; ++i) {
-    doubles->push_back(DoubleUniform(min, max));
+  if (min >= max) {
+    LOG(WARNING) << "min >= max. Returning min.";
+    doubles->resize(doubles->size() + count, min);
+    return;
+  }
+
+  const size_t offset = doubles->size();
+  doubles->resize(offset + count);
+  double* values = doubles->data() + offset;
+
+  const double scale = (max - min) * (1.0 / 9007199254740992.0);
+  uint64_t bits[kBlockSize];
+  for (size_t begin = 0; begin < count; begin += kBlockSize) {
+    const size_t block = std::min(kBlockSize, count - begin);
+    NextLanes(block, bits);
+    for (size_t i = 0; i < block; ++i) {
+      values[begin + i] = min + static_cast<double>(bits[i] >> 11) * scale;
+    }
   }
 }
 
@@ -164,8 +365,19 @@ void RandomGenerator::DoublesGaussian(size_t count, double mean, double stddev,
     return;
   }
 
-  for (size_t i = 0; i < count; ++i) {
-    doubles->push_back(DoubleGaussian(mean, stddev));
+  // Box-muller on pairs of uniforms, using both the sine and cosine.
+  std::vector<double> uniform;
+  DoublesUniform(count + (count & 1), 0.0, 1.0, &uniform);
+
+  const size_t offset = doubles->size();
+  doubles->resize(offset + count);
+  double* values = doubles->data() + offset;
+  for (size_t i = 0; i < count; i += 2) {
+    const double radius = stddev * sqrt(-2.0 * log(1.0 - uniform[i]));
+    const double angle = 2.0 * M_PI * uniform[i + 1];
+    values[i] = mean + radius * cos(angle);
+    if (i + 1 < count)
+      values[i + 1] = mean + radius * sin(angle);
   }
 }
 
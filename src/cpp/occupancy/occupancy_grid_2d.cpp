@@ -44,6 +44,7 @@
 #include <geometry/point_2d.h>
 #include <scene/obstacle_2d.h>
 
+#include <algorithm>
 #include <cmath>
 #include <glog/logging.h>
 
@@ -76,8 +77,8 @@ namespace path {
   }
 
   // Insert a point.
-  void OccupancyGrid2D::Insert(Point2D::Ptr point) {
-    if (!IsValidPoint(point)) return;
+  Obstacle2D::Ptr OccupancyGrid2D::Insert(Point2D::Ptr point) {
+    if (!IsValidPoint(point)) return Obstacle2D::Ptr(nullptr);
 
     // Find the nearest bin and insert.
     int jj = static_cast<int>((point->x - xmin_) / block_size_);
@@ -94,7 +95,10 @@ namespace path {
       Obstacle2D::Ptr obstacle =
         Obstacle2D::Create(bin_center->x, bin_center->y, 0.5 * block_size_);
       scene_.AddObstacle(obstacle);
+      return obstacle;
     }
+
+    return Obstacle2D::Ptr(nullptr);
   }
 
   // Get number of points in the bin containing the specified point.
@@ -121,6 +125,28 @@ namespace path {
                            (static_cast<float>(ii) + 0.5) * block_size_);
   }
 
+  // Row and column of the cell containing a point. Points on the upper
+  // bounds belong to the last cell.
+  bool OccupancyGrid2D::GetCell(const Point2D::Value& point,
+                                int& row, int& col) const {
+    if (point.x < xmin_ || point.x > xmax_ ||
+        point.y < ymin_ || point.y > ymax_)
+      return false;
+
+    col = std::min(static_cast<int>((point.x - xmin_) / block_size_),
+                   ncols_ - 1);
+    row = nrows_ - 1 - std::min(static_cast<int>((point.y - ymin_) /
+                                                 block_size_), nrows_ - 1);
+    return true;
+  }
+
+  // Center of the cell at (row, column).
+  Point2D::Value OccupancyGrid2D::GetCellCenter(int row, int col) const {
+    return Point2D::Value(
+      xmin_ + (static_cast<float>(col) + 0.5) * block_size_,
+      ymin_ + (static_cast<float>(nrows_ - 1 - row) + 0.5) * block_size_);
+  }
+
   // Visualize this occupancy grid.
   void OccupancyGrid2D::Visualize(const std::string& title) const {
     MatrixXf map_matrix = grid_.cast<float>();
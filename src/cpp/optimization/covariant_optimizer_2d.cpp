@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class smooths a trajectory through a Scene2DContinuous by covariant
+// gradient descent, as in CHOMP.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <optimization/covariant_optimizer_2d.h>
+#include <math/banded_cholesky.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace path {
+
+  // Cholesky factor of the smoothness matrix over 'size' free waypoints:
+  // 2 on the diagonal and -1 beside it, with both endpoints fixed. The
+  // factor for the last size is kept, and never changes once built, so
+  // callers may share it without locking.
+  std::shared_ptr<const math::BandedCholesky>
+  CovariantOptimizer2D::GetSmoothnessFactor(size_t size) const {
+    std::lock_guard<std::mutex> lock(factor_mutex_);
+    if (factor_ == nullptr || factor_->Size() != size) {
+      std::shared_ptr<math::BandedCholesky> smoothness(
+        new math::BandedCholesky(size, 1));
+      for (size_t ii = 0; ii < size; ii++) {
+        smoothness->Set(ii, ii, 2.0);
+        if (ii > 0)
+          smoothness->Set(ii, ii - 1, -1.0);
+      }
+      CHECK(smoothness->Factorize());
+      factor_ = smoothness;
+    }
+
+    return factor_;
+  }
+
+  // Optimize the given trajectory.
+  Trajectory2D::Ptr CovariantOptimizer2D::Optimize(Trajectory2D::Ptr path,
+                                                   size_t max_iters,
+                                                   float min_avg_displacement)
+    const {
+    CHECK_NOTNULL(path.get());
+    CHECK_GT(smoothness_weight_, 0.0);
+
+    const size_t num_points = path->Size();
+    Trajectory2D::Ptr optimized = Trajectory2D::Create(
+      std::vector<float>(path->GetX(), path->GetX() + num_points),
+      std::vector<float>(path->GetY(), path->GetY() + num_points));
+    if (num_points < 3)
+      return optimized;
+
+    // Interior waypoints are the free variables.
+    const size_t num_free = num_points - 2;
+    std::shared_ptr<const math::BandedCholesky> factor =
+      GetSmoothnessFactor(num_free);
+
+    // Objective at the current path, and its preconditioned gradient. The
+    // gradient is divided by the smoothness weight, so that the smoothness
+    // part of the step is exactly the offset from the smoothest path.
+    std::vector<double> step_x(num_free), step_y(num_free);
+    auto evaluate = [&](const float* px, const float* py) {
+      double objective = 0.0;
+      for (size_t ii = 0; ii < num_free; ii++) {
+        const size_t jj = ii + 1;
+        Point2D::Value derivative;
+        objective += cost_weight_ *
+          scene_.Cost(Point2D::Value(px[jj], py[jj]), &derivative);
+        step_x[ii] = (cost_weight_ * derivative.x) / smoothness_weight_ +
+          2.0 * px[jj] - px[jj - 1] - px[jj + 1];
+        step_y[ii] = (cost_weight_ * derivative.y) / smoothness_weight_ +
+          2.0 * py[jj] - py[jj - 1] - py[jj + 1];
+      }
+      for (size_t ii = 0; ii + 1 < num_points; ii++) {
+        const double dx = px[ii + 1] - px[ii];
+        const double dy = py[ii + 1] - py[ii];
+        objective += 0.5 * smoothness_weight_ * (dx * dx + dy * dy);
+      }
+
+      factor->Solve(step_x.data());
+      factor->Solve(step_y.data());
+      return objective;
+    };
+
+    float* x = optimized->GetMutableX();
+    float* y = optimized->GetMutableY();
+    double objective = evaluate(x, y);
+
+    // Preconditioning stretches the obstacle term along smooth directions,
+    // so a fixed step can overshoot. Steps that increase the objective are
+    // retried at half the size. The backtracking factor is applied after
+    // the displacement cap, so that a capped step also shrinks.
+    std::vector<float> candidate_x(x, x + num_points);
+    std::vector<float> candidate_y(y, y + num_points);
+    std::vector<double> last_step_x, last_step_y;
+    double backtrack = 1.0;
+    for (size_t iter = 0; iter < max_iters; iter++) {
+      // Scale the whole step, preserving its direction, so that no point
+      // moves too far.
+      double max_length = 0.0;
+      for (size_t ii = 0; ii < num_free; ii++) {
+        max_length = std::max(max_length, std::sqrt(
+          step_x[ii] * step_x[ii] + step_y[ii] * step_y[ii]));
+      }
+
+      double scale = step_size_;
+      if (scale * max_length > max_point_displacement_)
+        scale = max_point_displacement_ / max_length;
+      scale *= backtrack;
+
+      double total_displacement = 0.0;
+      for (size_t ii = 0; ii < num_free; ii++) {
+        candidate_x[ii + 1] = x[ii + 1] - scale * step_x[ii];
+        candidate_y[ii + 1] = y[ii + 1] - scale * step_y[ii];
+        total_displacement += scale * std::sqrt(
+          step_x[ii] * step_x[ii] + step_y[ii] * step_y[ii]);
+      }
+
+      // Keep the current step direction in case the candidate is rejected.
+      last_step_x = step_x;
+      last_step_y = step_y;
+      const double candidate_objective =
+        evaluate(candidate_x.data(), candidate_y.data());
+      if (candidate_objective > objective) {
+        step_x.swap(last_step_x);
+        step_y.swap(last_step_y);
+        backtrack *= 0.5;
+        continue;
+      }
+
+      std::copy(candidate_x.begin(), candidate_x.end(), x);
+      std::copy(candidate_y.begin(), candidate_y.end(), y);
+      objective = candidate_objective;
+      backtrack = std::min(1.0, 2.0 * backtrack);
+
+      if (total_displacement / static_cast<double>(num_points) <
+          min_avg_displacement) {
+        VLOG(1) << "Covariant descent converged after " << iter + 1
+                << " iterations.";
+        break;
+      }
+    }
+
+    optimized->RecomputeLength();
+    return optimized;
+  }
+
+} //\ namespace path
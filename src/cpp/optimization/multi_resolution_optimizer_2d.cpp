@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class optimizes a trajectory coarse to fine, refining upsampled
+// copies of the path with CovariantOptimizer2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <optimization/multi_resolution_optimizer_2d.h>
+
+#include <glog/logging.h>
+
+namespace path {
+
+  MultiResolutionOptimizer2D::MultiResolutionOptimizer2D(
+                                  const Scene2DContinuous& scene,
+                                  float cost_weight, float smoothness_weight,
+                                  unsigned int num_levels,
+                                  unsigned int upsample,
+                                  float step_size,
+                                  float max_point_displacement)
+    : num_levels_(num_levels),
+      upsample_(upsample) {
+    CHECK_GT(num_levels_, 0u);
+
+    // Ratio of the number of segments at the finest level to the number at
+    // the coarsest one.
+    float coarseness = 1.0;
+    for (unsigned int level = 1; level < num_levels_; level++)
+      coarseness *= static_cast<float>(upsample_ + 1);
+
+    for (unsigned int level = 0; level < num_levels_; level++) {
+      if (level > 0)
+        coarseness /= static_cast<float>(upsample_ + 1);
+
+      optimizers_.emplace_back(new CovariantOptimizer2D(
+        scene, coarseness * cost_weight, smoothness_weight / coarseness,
+        step_size, max_point_displacement));
+    }
+  }
+
+  // Optimize the given trajectory.
+  Trajectory2D::Ptr MultiResolutionOptimizer2D::Optimize(
+                                                  Trajectory2D::Ptr path,
+                                                  size_t max_iters,
+                                                  float min_avg_displacement)
+    const {
+    CHECK_NOTNULL(path.get());
+
+    Trajectory2D::Ptr optimized = path;
+    for (unsigned int level = 0; level < num_levels_; level++) {
+      if (level > 0)
+        optimized->Upsample(upsample_);
+
+      optimized = optimizers_[level]->Optimize(optimized, max_iters,
+                                               min_avg_displacement);
+      VLOG(1) << "Optimized level " << level << " with "
+              << optimized->Size() << " waypoints.";
+    }
+
+    return optimized;
+  }
+
+} //\ namespace path
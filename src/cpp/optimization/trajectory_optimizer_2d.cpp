@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class smooths a trajectory through a Scene2DContinuous by solving a
+// sparse nonlinear least-squares problem with Ceres.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <optimization/trajectory_optimizer_2d.h>
+
+#include <ceres/ceres.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace path {
+
+  namespace {
+
+    // Obstacle cost at one waypoint, as the residual sqrt(2 * w * cost) so
+    // that half its square is the weighted cost.
+    class ObstacleResidual : public ceres::SizedCostFunction<1, 2> {
+    public:
+      ObstacleResidual(const Scene2DContinuous& scene, double weight)
+        : scene_(scene), weight_(weight) {}
+
+      bool Evaluate(double const* const* parameters,
+                    double* residuals, double** jacobians) const override {
+        const Point2D::Value point(parameters[0][0], parameters[0][1]);
+        Point2D::Value derivative;
+        const double cost = scene_.Cost(point, &derivative);
+        residuals[0] = std::sqrt(2.0 * weight_ * std::max(0.0, cost));
+
+        // d/dp sqrt(2 w c) = w c' / sqrt(2 w c). Far from every obstacle the
+        // residual vanishes and so does the Jacobian.
+        if (jacobians != nullptr && jacobians[0] != nullptr) {
+          const double scale = (residuals[0] > kMinResidual) ?
+            weight_ / residuals[0] : 0.0;
+          jacobians[0][0] = scale * derivative.x;
+          jacobians[0][1] = scale * derivative.y;
+        }
+
+        return true;
+      }
+
+    private:
+      static constexpr double kMinResidual = 1e-12;
+
+      const Scene2DContinuous& scene_;
+      const double weight_;
+    };
+
+    // Spacing between consecutive waypoints, sqrt(w) * (p1 - p0).
+    class SmoothnessResidual : public ceres::SizedCostFunction<2, 2, 2> {
+    public:
+      explicit SmoothnessResidual(double weight)
+        : scale_(std::sqrt(weight)) {}
+
+      bool Evaluate(double const* const* parameters,
+                    double* residuals, double** jacobians) const override {
+        residuals[0] = scale_ * (parameters[1][0] - parameters[0][0]);
+        residuals[1] = scale_ * (parameters[1][1] - parameters[0][1]);
+
+        // Jacobians are row-major, one row per residual.
+        if (jacobians != nullptr) {
+          if (jacobians[0] != nullptr) {
+            jacobians[0][0] = -scale_;
+            jacobians[0][1] = 0.0;
+            jacobians[0][2] = 0.0;
+            jacobians[0][3] = -scale_;
+          }
+          if (jacobians[1] != nullptr) {
+            jacobians[1][0] = scale_;
+            jacobians[1][1] = 0.0;
+            jacobians[1][2] = 0.0;
+            jacobians[1][3] = scale_;
+          }
+        }
+
+        return true;
+      }
+
+    private:
+      const double scale_;
+    };
+
+  } //\ namespace
+
+  // Optimize the given trajectory.
+  Trajectory2D::Ptr TrajectoryOptimizer2D::Optimize(Trajectory2D::Ptr path,
+                                                    size_t max_iters,
+                                                    float tolerance,
+                                                    bool parallel) const {
+    CHECK_NOTNULL(path.get());
+
+    const size_t num_points = path->Size();
+    const float* x = path->GetX();
+    const float* y = path->GetY();
+    if (num_points < 3) {
+      return Trajectory2D::Create(std::vector<float>(x, x + num_points),
+                                  std::vector<float>(y, y + num_points));
+    }
+
+    // One two-element parameter block per waypoint.
+    std::vector<double> points(2 * num_points);
+    for (size_t ii = 0; ii < num_points; ii++) {
+      points[2 * ii] = x[ii];
+      points[2 * ii + 1] = y[ii];
+    }
+
+    // The problem owns and deletes the residuals.
+    ceres::Problem problem;
+    for (size_t ii = 1; ii + 1 < num_points; ii++) {
+      problem.AddResidualBlock(new ObstacleResidual(scene_, cost_weight_),
+                               nullptr, &points[2 * ii]);
+    }
+    for (size_t ii = 0; ii + 1 < num_points; ii++) {
+      problem.AddResidualBlock(new SmoothnessResidual(smoothness_weight_),
+                               nullptr, &points[2 * ii], &points[2 * ii + 2]);
+    }
+    problem.SetParameterBlockConstant(&points[0]);
+    problem.SetParameterBlockConstant(&points[2 * num_points - 2]);
+
+    // The normal equations are block tridiagonal, so sparse Cholesky is
+    // linear in the number of waypoints. Fall back to conjugate gradients on
+    // the normal equations, which also keeps the sparsity, if Ceres was
+    // built without a sparse backend.
+    ceres::Solver::Options options;
+    options.linear_solver_type = ceres::SPARSE_NORMAL_CHOLESKY;
+    options.max_num_iterations = static_cast<int>(max_iters);
+    options.parameter_tolerance = tolerance;
+
+    // Residuals only read the scene, so waypoints can be evaluated in any
+    // order. Evaluation dominates the cost of each iteration.
+    if (parallel) {
+      options.num_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    std::string error;
+    if (!options.IsValid(&error)) {
+      VLOG(1) << "Sparse Cholesky is unavailable (" << error
+              << "), using CGNR.";
+      options.linear_solver_type = ceres::CGNR;
+    }
+    if (!options.IsValid(&error)) {
+      LOG(ERROR) << "No sparse linear solver is available (" << error
+                 << "). Returning the trajectory unchanged.";
+      return Trajectory2D::Create(std::vector<float>(x, x + num_points),
+                                  std::vector<float>(y, y + num_points));
+    }
+
+    ceres::Solver::Summary summary;
+    ceres::Solve(options, &problem, &summary);
+    VLOG(1) << summary.BriefReport();
+
+    std::vector<float> optimized_x(num_points), optimized_y(num_points);
+    for (size_t ii = 0; ii < num_points; ii++) {
+      optimized_x[ii] = static_cast<float>(points[2 * ii]);
+      optimized_y[ii] = static_cast<float>(points[2 * ii + 1]);
+    }
+
+    return Trajectory2D::Create(optimized_x, optimized_y);
+  }
+
+} //\ namespace path
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines an A* planner that searches the cells of an
+// OccupancyGrid2D directly, with 8-connected moves and the octile distance
+// heuristic, which is exact on an empty grid:
+// + http://theory.stanford.edu/~amitp/GameProgramming/Heuristics.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/grid_astar_planner_2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glog/logging.h>
+
+namespace path {
+
+  namespace {
+    const float kSqrt2 = 1.41421356237f;
+    const int kNoCell = -1;
+    const uint8_t kNoDirection = 8;
+
+    // Directions N, S, W, E, NW, NE, SW, SE. Row 0 is the top of the map.
+    const int kRowSteps[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    const int kColSteps[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+    // Index of the direction (dr, dc), each of which is -1, 0 or 1.
+    inline uint8_t Direction(int dr, int dc) {
+      if (dc == 0) return (dr < 0) ? 0 : 1;
+      if (dr == 0) return (dc < 0) ? 2 : 3;
+      return 4 + 2 * (dr > 0) + (dc > 0);
+    }
+
+    inline bool IsDiagonal(uint8_t direction) { return direction >= 4; }
+
+    inline int Sign(int x) { return (x > 0) - (x < 0); }
+
+    // Octile distance between two cells, in cells.
+    inline float Octile(int row1, int col1, int row2, int col2) {
+      const int dr = std::abs(row1 - row2);
+      const int dc = std::abs(col1 - col2);
+      return static_cast<float>(std::max(dr, dc)) +
+        (kSqrt2 - 1.0f) * static_cast<float>(std::min(dr, dc));
+    }
+  } //\ namespace
+
+  GridAStarPlanner2D::GridAStarPlanner2D(const OccupancyGrid2D& grid,
+                                         float robot_radius)
+    : grid_(grid), robot_radius_(robot_radius),
+      nrows_(grid.GetNRows()), ncols_(grid.GetNCols()),
+      jump_point_search_(false), jump_tables_valid_(false),
+      current_query_(0), cost_(std::numeric_limits<float>::infinity()),
+      num_expanded_(0) {
+    CHECK(robot_radius_ >= 0.0);
+
+    const size_t num_cells = static_cast<size_t>(nrows_) * ncols_;
+    blocked_.resize(num_cells);
+    query_.resize(num_cells, 0);
+    g_.resize(num_cells);
+    parent_.resize(num_cells);
+    direction_.resize(num_cells);
+    heap_position_.resize(num_cells);
+
+    Inflate();
+  }
+
+  // Mark every cell within reach of an occupied cell. Occupied cells hold a
+  // disc of radius half a block at their centers, so a robot centered in a
+  // cell 'd' blocks away collides if d * block < 0.5 * block + radius.
+  void GridAStarPlanner2D::Inflate() {
+    const MatrixXi& counts = grid_.GetGrid();
+    const float reach = 0.5 + robot_radius_ / grid_.GetBlockSize();
+    const int extent = static_cast<int>(std::ceil(reach));
+
+    // Offsets within reach, computed once.
+    std::vector<int> stencil_rows, stencil_cols;
+    for (int dr = -extent; dr <= extent; dr++) {
+      for (int dc = -extent; dc <= extent; dc++) {
+        if (static_cast<float>(dr * dr + dc * dc) < reach * reach) {
+          stencil_rows.push_back(dr);
+          stencil_cols.push_back(dc);
+        }
+      }
+    }
+
+    std::fill(blocked_.begin(), blocked_.end(), 0);
+    for (int col = 0; col < ncols_; col++) {
+      for (int row = 0; row < nrows_; row++) {
+        if (counts(row, col) == 0)
+          continue;
+
+        for (size_t ii = 0; ii < stencil_rows.size(); ii++) {
+          const int r = row + stencil_rows[ii];
+          const int c = col + stencil_cols[ii];
+          if (r >= 0 && r < nrows_ && c >= 0 && c < ncols_)
+            blocked_[r * ncols_ + c] = 1;
+        }
+      }
+    }
+
+    jump_tables_valid_ = false;
+  }
+
+  // Is this cell blocked?
+  bool GridAStarPlanner2D::IsBlocked(int row, int col) const {
+    CHECK(row >= 0 && row < nrows_ && col >= 0 && col < ncols_);
+    return blocked_[row * ncols_ + col] != 0;
+  }
+
+  // Length of the last path found.
+  float GridAStarPlanner2D::GetCost() const {
+    return cost_ * grid_.GetBlockSize();
+  }
+
+  // Turn Jump Point Search on or off.
+  void GridAStarPlanner2D::SetJumpPointSearch(bool enabled) {
+    // Jump distances are stored in 16 bits.
+    CHECK(!enabled || std::max(nrows_, ncols_) <=
+          std::numeric_limits<int16_t>::max());
+    jump_point_search_ = enabled;
+  }
+
+  // The algorithm. See header for references.
+  Status GridAStarPlanner2D::PlanTrajectory(const Point2D::Value& origin,
+                                            const Point2D::Value& goal,
+                                            Trajectory2D::Ptr& path) {
+    cost_ = std::numeric_limits<float>::infinity();
+    num_expanded_ = 0;
+
+    int origin_row, origin_col, goal_row, goal_col;
+    if (!grid_.GetCell(origin, origin_row, origin_col) ||
+        !grid_.GetCell(goal, goal_row, goal_col))
+      return Status::InvalidArgument("Endpoint is off the grid.");
+
+    const int start = origin_row * ncols_ + origin_col;
+    const int target = goal_row * ncols_ + goal_col;
+    if (blocked_[start] || blocked_[target])
+      return Status::FailedPrecondition("Endpoint is blocked.");
+
+    if (jump_point_search_ && !jump_tables_valid_)
+      BuildJumpTables();
+
+    // Start a new query. Stale values from earlier queries are ignored
+    // because their tags no longer match; on wraparound, clear the tags.
+    current_query_ += 2;
+    if (current_query_ == 0) {
+      std::fill(query_.begin(), query_.end(), 0);
+      current_query_ = 2;
+    }
+    heap_.clear();
+
+    query_[start] = current_query_;
+    g_[start] = 0.0;
+    parent_[start] = kNoCell;
+    direction_[start] = kNoDirection;
+    Push(start, Octile(origin_row, origin_col, goal_row, goal_col));
+
+    bool found = false;
+    while (!heap_.empty()) {
+      const int cell = Pop();
+      if (cell == target) {
+        found = true;
+        break;
+      }
+
+      query_[cell] = current_query_ + 1;
+      num_expanded_++;
+
+      if (jump_point_search_)
+        ExpandJumpPoints(cell, goal_row, goal_col);
+      else
+        ExpandNeighbors(cell, goal_row, goal_col);
+    }
+
+    if (!found) {
+      VLOG(1) << "No path found after expanding " << num_expanded_
+              << " cells.";
+      return Status::NotFound("Goal is unreachable.");
+    }
+
+    VLOG(1) << "Found a path after expanding " << num_expanded_ << " cells.";
+    cost_ = g_[target];
+
+    // Walk back from the goal, filling in the cells a jump skips and
+    // keeping only the cells strictly between the endpoints, then put the
+    // exact endpoints at either end.
+    std::vector<Point2D::Value> points;
+    points.push_back(goal);
+    for (int cell = target; cell != start; cell = parent_[cell]) {
+      const int parent = parent_[cell];
+      const int dr = Sign(parent / ncols_ - cell / ncols_);
+      const int dc = Sign(parent % ncols_ - cell % ncols_);
+      int row = cell / ncols_ + dr;
+      int col = cell % ncols_ + dc;
+      for (; row * ncols_ + col != parent; row += dr, col += dc)
+        points.push_back(grid_.GetCellCenter(row, col));
+      if (parent != start)
+        points.push_back(grid_.GetCellCenter(row, col));
+    }
+    points.push_back(origin);
+    std::reverse(points.begin(), points.end());
+
+    path = Trajectory2D::Create(points);
+    return Status::Ok();
+  }
+
+  // Reach 'next' from 'cell', unless it is closed or already reached more
+  // cheaply.
+  void GridAStarPlanner2D::Relax(int cell, int next, float step,
+                                 uint8_t direction,
+                                 int goal_row, int goal_col) {
+    if (query_[next] == current_query_ + 1)
+      return;
+
+    const float g = g_[cell] + step;
+    if (query_[next] != current_query_) {
+      query_[next] = current_query_;
+      g_[next] = g;
+      parent_[next] = cell;
+      direction_[next] = direction;
+      Push(next, g + Octile(next / ncols_, next % ncols_,
+                            goal_row, goal_col));
+    } else if (g < g_[next]) {
+      // Decrease key. The heuristic term is unchanged.
+      Entry& entry = heap_[heap_position_[next]];
+      entry.f -= g_[next] - g;
+      g_[next] = g;
+      parent_[next] = cell;
+      direction_[next] = direction;
+      SiftUp(heap_position_[next]);
+    }
+  }
+
+  // Plain A*: every free neighbor is a successor.
+  void GridAStarPlanner2D::ExpandNeighbors(int cell,
+                                           int goal_row, int goal_col) {
+    const int row = cell / ncols_;
+    const int col = cell % ncols_;
+    for (uint8_t ii = 0; ii < 8; ii++) {
+      const int r = row + kRowSteps[ii];
+      const int c = col + kColSteps[ii];
+      if (r < 0 || r >= nrows_ || c < 0 || c >= ncols_)
+        continue;
+
+      const int next = r * ncols_ + c;
+      if (blocked_[next])
+        continue;
+
+      // Diagonal moves may not cut a blocked corner.
+      if (IsDiagonal(ii) &&
+          (blocked_[row * ncols_ + c] || blocked_[r * ncols_ + col]))
+        continue;
+
+      Relax(cell, next, IsDiagonal(ii) ? kSqrt2 : 1.0f, ii,
+            goal_row, goal_col);
+    }
+  }
+
+  // Jump Point Search: only the next jump point in each direction that is
+  // not pruned is a successor. Without corner cutting, a diagonal move has
+  // no forced neighbors, so after one only its two straight components and
+  // the diagonal itself are searched. After a straight move, the
+  // perpendicular directions are searched as well, since a jump point is
+  // where one of them opens up.
+  void GridAStarPlanner2D::ExpandJumpPoints(int cell,
+                                            int goal_row, int goal_col) {
+    const int row = cell / ncols_;
+    const int col = cell % ncols_;
+
+    uint8_t directions[8];
+    size_t num_directions = 0;
+    const uint8_t from = direction_[cell];
+    if (from == kNoDirection) {
+      for (uint8_t ii = 0; ii < 8; ii++)
+        directions[num_directions++] = ii;
+    } else if (IsDiagonal(from)) {
+      directions[num_directions++] = Direction(kRowSteps[from], 0);
+      directions[num_directions++] = Direction(0, kColSteps[from]);
+      directions[num_directions++] = from;
+    } else {
+      const int dr = kRowSteps[from];
+      const int dc = kColSteps[from];
+      directions[num_directions++] = from;
+      directions[num_directions++] = Direction(dr + dc, dc + dr);
+      directions[num_directions++] = Direction(dr - dc, dc - dr);
+      directions[num_directions++] = Direction(dc, dr);
+      directions[num_directions++] = Direction(-dc, -dr);
+    }
+
+    const int to_goal_row = goal_row - row;
+    const int to_goal_col = goal_col - col;
+    for (size_t ii = 0; ii < num_directions; ii++) {
+      const uint8_t direction = directions[ii];
+      const int dr = kRowSteps[direction];
+      const int dc = kColSteps[direction];
+      const int distance = jump_[8 * cell + direction];
+      const int free_steps = std::abs(distance);
+
+      // Stop short at the goal, or, on a diagonal, where the goal's row or
+      // column is crossed so a straight jump can finish the path.
+      int steps = (distance > 0) ? distance : 0;
+      if (!IsDiagonal(direction)) {
+        const int along = dr * to_goal_row + dc * to_goal_col;
+        const int across = dc * to_goal_row + dr * to_goal_col;
+        if (across == 0 && along > 0 && along <= free_steps)
+          steps = along;
+      } else if (Sign(to_goal_row) == dr && Sign(to_goal_col) == dc) {
+        const int along = std::min(std::abs(to_goal_row),
+                                   std::abs(to_goal_col));
+        if (along <= free_steps)
+          steps = along;
+      }
+
+      if (steps == 0)
+        continue;
+
+      const int next = (row + steps * dr) * ncols_ + col + steps * dc;
+      Relax(cell, next,
+            static_cast<float>(steps) * (IsDiagonal(direction) ? kSqrt2 : 1.0f),
+            direction, goal_row, goal_col);
+    }
+  }
+
+  // Precompute jump distances. Each cell's entry in a direction follows
+  // from its neighbor's in that direction, so cells are visited so that the
+  // neighbor comes first.
+  void GridAStarPlanner2D::BuildJumpTables() {
+    jump_.assign(8 * blocked_.size(), 0);
+
+    // Is (row, col) free? Off the grid counts as blocked.
+    const int nrows = nrows_, ncols = ncols_;
+    const std::vector<uint8_t>& blocked = blocked_;
+    auto free = [&](int row, int col) {
+      return row >= 0 && row < nrows && col >= 0 && col < ncols &&
+        !blocked[row * ncols + col];
+    };
+
+    // Straight directions first, since diagonal entries depend on them.
+    for (uint8_t direction = 0; direction < 8; direction++) {
+      const int dr = kRowSteps[direction];
+      const int dc = kColSteps[direction];
+      for (int ii = 0; ii < nrows_; ii++) {
+        const int row = (dr > 0) ? nrows_ - 1 - ii : ii;
+        for (int jj = 0; jj < ncols_; jj++) {
+          const int col = (dc > 0) ? ncols_ - 1 - jj : jj;
+          const int r = row + dr;
+          const int c = col + dc;
+          if (!free(r, c) ||
+              (IsDiagonal(direction) && !(free(row, c) && free(r, col))))
+            continue;
+
+          // Is the neighbor a jump point? Moving straight, that is where a
+          // perpendicular cell opens up that was blocked beside this one.
+          // Moving diagonally, it is where a straight jump finds one.
+          const int next = r * ncols_ + c;
+          bool is_jump_point;
+          if (!IsDiagonal(direction)) {
+            is_jump_point = (free(r + dc, c + dr) && !free(row + dc, col + dr))
+              || (free(r - dc, c - dr) && !free(row - dc, col - dr));
+          } else {
+            is_jump_point = jump_[8 * next + Direction(dr, 0)] > 0 ||
+              jump_[8 * next + Direction(0, dc)] > 0;
+          }
+
+          const int16_t distance = jump_[8 * next + direction];
+          int16_t& entry = jump_[8 * (row * ncols_ + col) + direction];
+          if (is_jump_point)
+            entry = 1;
+          else
+            entry = (distance > 0) ? distance + 1 : distance - 1;
+        }
+      }
+    }
+
+    jump_tables_valid_ = true;
+  }
+
+  // Add a cell to the open list.
+  void GridAStarPlanner2D::Push(int cell, float f) {
+    Entry entry;
+    entry.f = f;
+    entry.cell = cell;
+    heap_position_[cell] = heap_.size();
+    heap_.push_back(entry);
+    SiftUp(heap_.size() - 1);
+  }
+
+  // Remove and return the cell with the smallest f.
+  int GridAStarPlanner2D::Pop() {
+    const int cell = heap_.front().cell;
+    heap_.front() = heap_.back();
+    heap_position_[heap_.front().cell] = 0;
+    heap_.pop_back();
+    if (!heap_.empty())
+      SiftDown(0);
+
+    return cell;
+  }
+
+  // Ties on f go to the entry farther along, i.e. with the larger g, which
+  // is the one closer to the goal.
+  bool GridAStarPlanner2D::Less(const Entry& a, const Entry& b) const {
+    return a.f < b.f || (a.f == b.f && g_[a.cell] > g_[b.cell]);
+  }
+
+  void GridAStarPlanner2D::SiftUp(size_t position) {
+    const Entry entry = heap_[position];
+    while (position > 0) {
+      const size_t parent = (position - 1) / 2;
+      if (!Less(entry, heap_[parent]))
+        break;
+
+      heap_[position] = heap_[parent];
+      heap_position_[heap_[position].cell] = position;
+      position = parent;
+    }
+
+    heap_[position] = entry;
+    heap_position_[entry.cell] = position;
+  }
+
+  void GridAStarPlanner2D::SiftDown(size_t position) {
+    const Entry entry = heap_[position];
+    const size_t size = heap_.size();
+    while (true) {
+      size_t child = 2 * position + 1;
+      if (child >= size)
+        break;
+      if (child + 1 < size && Less(heap_[child + 1], heap_[child]))
+        child++;
+      if (!Less(heap_[child], entry))
+        break;
+
+      heap_[position] = heap_[child];
+      heap_position_[heap_[position].cell] = position;
+      position = child;
+    }
+
+    heap_[position] = entry;
+    heap_position_[entry.cell] = position;
+  }
+
+} //\ namespace path
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines an RRT planner that repairs its tree, rather than
+// rebuilding it, when obstacles are added to the scene.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/incremental_rrt_planner_2d.h>
+
+#include <algorithm>
+#include <limits>
+#include <glog/logging.h>
+
+namespace path {
+
+  // The algorithm. See header for references.
+  Status IncrementalRRTPlanner2D::PlanTrajectory(
+                                  const util::Deadline& deadline,
+                                  const util::CancellationToken::Ptr& cancel,
+                                  Trajectory2D::Ptr& path) {
+    const Point2D::Value origin(*origin_);
+    const Point2D::Value goal(*goal_);
+
+    // Initialize the tree. The origin is always node 0.
+    if (tree_.Size() == 0)
+      tree_.Insert(origin);
+
+    if (tree_.IsRemoved(0)) {
+      path = Trajectory2D::Ptr(nullptr);
+      return Status::FailedPrecondition("Origin is blocked.");
+    }
+
+    // Check if a path already exists.
+    if (goal_index_ != Node2D::kNone) {
+      path = tree_.GetTrajectory(goal_index_);
+      return Status::Ok();
+    }
+
+    Status status = Status::NotFound("Sample budget exhausted.");
+    for (size_t ii = 0; ii < max_samples_; ii++) {
+      if (cancel != nullptr && cancel->IsCancelled()) {
+        status = Status::Cancelled();
+        break;
+      }
+      if (deadline.Expired()) {
+        status = Status::DeadlineExceeded();
+        break;
+      }
+
+      // Pick a random point in the scene.
+      const Point2D::Value random_point = sampler_->Sample(
+        0, num_samples_++, std::numeric_limits<float>::infinity());
+
+      // Take a step toward it from the nearest live node.
+      const Node2D::Index nearest = tree_.GetNearestIndex(random_point);
+      const Point2D::Value nearest_point = tree_.GetPoint(nearest);
+      const Point2D::Value step =
+        Point2D::StepToward(nearest_point, random_point, step_size_);
+      if (!robot_.LineOfSight(nearest_point, step))
+        continue;
+
+      const Node2D::Index step_index = tree_.Insert(step, nearest);
+      if (step_index == Node2D::kNone)
+        continue;
+
+      // Go straight to the goal if it is visible.
+      if (robot_.LineOfSight(step, goal)) {
+        goal_index_ = tree_.InsertSegment(step_index, goal, step_size_);
+        if (goal_index_ != Node2D::kNone) {
+          status = Status::Ok();
+          break;
+        }
+      }
+    }
+
+    // Return the trajectory to the goal, or as close to it as we got.
+    path = tree_.GetTrajectory((goal_index_ != Node2D::kNone) ?
+                               goal_index_ : tree_.GetNearestIndex(goal));
+    return status;
+  }
+
+  Trajectory2D::Ptr IncrementalRRTPlanner2D::PlanTrajectory() {
+    Trajectory2D::Ptr path;
+    PlanTrajectory(util::Deadline::Never(), nullptr, path);
+    return path;
+  }
+
+  // Repair the tree after obstacles have been added to a region.
+  size_t IncrementalRRTPlanner2D::Invalidate(const Point2D::Value& center,
+                                             float radius) {
+    if (tree_.Size() == 0)
+      return 0;
+
+    // An edge that passes within 'radius' plus the robot radius of 'center'
+    // ends within one more step of it, so only those edges are rechecked.
+    // A blocked edge orphans its child. The root has no edge, and is only
+    // orphaned if it is no longer feasible.
+    const float reach = radius + robot_.GetRadius() + step_size_;
+    tree_.RadiusSearch(center, reach, neighbors_);
+
+    blocked_.clear();
+    for (Node2D::Index index : neighbors_) {
+      const Node2D& node = tree_.GetNode(index);
+      const bool blocked = (node.parent == Node2D::kNone) ?
+        !robot_.IsFeasible(node.point) :
+        !robot_.LineOfSight(tree_.GetPoint(node.parent), node.point);
+      if (blocked)
+        blocked_.push_back(index);
+    }
+
+    if (blocked_.empty())
+      return 0;
+    std::sort(blocked_.begin(), blocked_.end());
+
+    // Detach every subtree below a blocked edge, parents before children.
+    // A blocked node may lie below another one, in which case it has
+    // already been removed with that subtree.
+    orphans_.clear();
+    for (Node2D::Index root : blocked_) {
+      if (tree_.IsRemoved(root))
+        continue;
+
+      const size_t first = orphans_.size();
+      Orphan orphan;
+      orphan.index = root;
+      orphan.parent = tree_.GetNode(root).parent;
+      orphan.blocked = true;
+      orphans_.push_back(orphan);
+
+      for (size_t ii = first; ii < orphans_.size(); ii++) {
+        const Node2D::Index parent = orphans_[ii].index;
+        for (Node2D::Index child = tree_.GetNode(parent).first_child;
+             child != Node2D::kNone;
+             child = tree_.GetNode(child).next_sibling) {
+          orphan.index = child;
+          orphan.parent = parent;
+          orphan.blocked =
+            std::binary_search(blocked_.begin(), blocked_.end(), child);
+          orphans_.push_back(orphan);
+        }
+      }
+
+      for (size_t ii = first; ii < orphans_.size(); ii++)
+        tree_.Remove(orphans_[ii].index);
+    }
+
+    // Reconnect. An intact edge is reused if its parent is back; otherwise
+    // the orphan joins the nearest visible live node within one step, which
+    // may be an orphan restored earlier in this loop. The root cannot be
+    // reconnected.
+    size_t num_lost = 0;
+    for (const Orphan& orphan : orphans_) {
+      if (orphan.index == 0) {
+        num_lost++;
+        continue;
+      }
+
+      if (!orphan.blocked && !tree_.IsRemoved(orphan.parent)) {
+        tree_.Restore(orphan.index, orphan.parent);
+        continue;
+      }
+
+      const Point2D::Value& point = tree_.GetPoint(orphan.index);
+      tree_.RadiusSearch(point, step_size_, neighbors_);
+      auto distance = [&](Node2D::Index neighbor) {
+        return Point2D::DistancePointToPoint(tree_.GetPoint(neighbor), point);
+      };
+      std::sort(neighbors_.begin(), neighbors_.end(),
+                [&](Node2D::Index a, Node2D::Index b) {
+                  return distance(a) < distance(b);
+                });
+
+      bool reconnected = false;
+      for (Node2D::Index neighbor : neighbors_) {
+        if (robot_.LineOfSight(tree_.GetPoint(neighbor), point)) {
+          tree_.Restore(orphan.index, neighbor);
+          reconnected = true;
+          break;
+        }
+      }
+
+      if (!reconnected)
+        num_lost++;
+    }
+
+    if (goal_index_ != Node2D::kNone && tree_.IsRemoved(goal_index_))
+      goal_index_ = Node2D::kNone;
+
+    VLOG(1) << "Orphaned " << orphans_.size() << " nodes, of which "
+            << num_lost << " could not be reconnected.";
+    return num_lost;
+  }
+
+  size_t IncrementalRRTPlanner2D::Invalidate(const Obstacle2D& obstacle) {
+    return Invalidate(obstacle.GetLocationValue(), obstacle.GetRadius());
+  }
+
+  // Set the sampler.
+  void IncrementalRRTPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
+
+} //\ namespace path
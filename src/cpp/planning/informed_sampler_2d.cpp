@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class implements informed sampling for RRT*:
+// + http://arxiv.org/abs/1404.2334
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/informed_sampler_2d.h>
+#include <math/counter_generator.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace path {
+
+  // Factory method.
+  InformedSampler2D::Ptr InformedSampler2D::Create(
+                                        const Scene2DContinuous& scene,
+                                        const Point2D::Value& origin,
+                                        const Point2D::Value& goal) {
+    InformedSampler2D::Ptr sampler(new InformedSampler2D(scene, origin, goal));
+    return sampler;
+  }
+
+  // Constructor.
+  InformedSampler2D::InformedSampler2D(const Scene2DContinuous& scene,
+                                       const Point2D::Value& origin,
+                                       const Point2D::Value& goal)
+    : scene_(scene),
+      center_(Point2D::MidPoint(origin, goal)),
+      focal_distance_(Point2D::DistancePointToPoint(origin, goal)),
+      cos_(1.0), sin_(0.0) {
+    if (focal_distance_ > 0.0) {
+      cos_ = (goal.x - origin.x) / focal_distance_;
+      sin_ = (goal.y - origin.y) / focal_distance_;
+    }
+  }
+
+  // Sample 'index' of stream 'stream'.
+  Point2D::Value InformedSampler2D::Sample(uint64_t stream, uint64_t index,
+                                           float best_cost) const {
+    // No path yet, or no room to improve it.
+    if (std::isinf(best_cost) || best_cost <= focal_distance_)
+      return scene_.GetRandomPointValue(stream, index);
+
+    // Semi-axes of the ellipse.
+    const float major = 0.5 * best_cost;
+    const float minor = 0.5 * std::sqrt(best_cost * best_cost -
+                                        focal_distance_ * focal_distance_);
+
+    // Draws use the scene's sample seed, but streams tagged in the high bits
+    // so that they are independent of the scene's own uniform samples.
+    const math::CounterGenerator generator(scene_.GetSampleSeed());
+    for (int ii = 0; ii < kMaxAttempts; ii++) {
+      const uint64_t tag = static_cast<uint64_t>(ii + 1) << 56;
+      double u, v;
+      generator.DoublePair(stream ^ tag, index, &u, &v);
+
+      // Uniform in the unit disk, then stretched and rotated onto the
+      // ellipse.
+      const double radius = std::sqrt(u);
+      const double angle = 2.0 * M_PI * v;
+      const float dx = major * radius * std::cos(angle);
+      const float dy = minor * radius * std::sin(angle);
+
+      const Point2D::Value point(center_.x + cos_ * dx - sin_ * dy,
+                                 center_.y + sin_ * dx + cos_ * dy);
+      if (scene_.IsInBounds(point))
+        return point;
+    }
+
+    // Most of the ellipse lies outside the scene. Draw from its bounding box
+    // clipped to the bounds instead, keeping points inside the ellipse;
+    // those are uniform over the same region as the draws above.
+    const float half_width = std::sqrt(major * major * cos_ * cos_ +
+                                       minor * minor * sin_ * sin_);
+    const float half_height = std::sqrt(major * major * sin_ * sin_ +
+                                        minor * minor * cos_ * cos_);
+    const float xmin = std::max(center_.x - half_width, scene_.GetXMin());
+    const float xmax = std::min(center_.x + half_width, scene_.GetXMax());
+    const float ymin = std::max(center_.y - half_height, scene_.GetYMin());
+    const float ymax = std::min(center_.y + half_height, scene_.GetYMax());
+
+    // The search below ends because the foci lie inside the ellipse, and
+    // normally inside the bounds. Guard against a scene that excludes both.
+    const float half_focal = 0.5 * focal_distance_;
+    const Point2D::Value origin(center_.x - half_focal * cos_,
+                                center_.y - half_focal * sin_);
+    const Point2D::Value goal(center_.x + half_focal * cos_,
+                              center_.y + half_focal * sin_);
+    if (!scene_.IsInBounds(origin) && !scene_.IsInBounds(goal))
+      return scene_.GetRandomPointValue(stream, index);
+
+    for (uint64_t ii = 0; ; ii++) {
+      const uint64_t tag = (ii + 1) << 32;
+      double u, v;
+      generator.DoublePair(stream ^ tag, index, &u, &v);
+
+      const Point2D::Value point(xmin + (xmax - xmin) * u,
+                                 ymin + (ymax - ymin) * v);
+
+      // Coordinates along the major and minor axes.
+      const float dx = point.x - center_.x;
+      const float dy = point.y - center_.y;
+      const float along = (cos_ * dx + sin_ * dy) / major;
+      const float across = (cos_ * dy - sin_ * dx) / minor;
+      if (along * along + across * across <= 1.0)
+        return point;
+    }
+  }
+
+} //\ namespace path
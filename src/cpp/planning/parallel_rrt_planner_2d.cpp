@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines a parallel version of RRTPlanner2D, which grows the
+// tree in rounds of concurrent sampling and collision checking followed by
+// serial insertion.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/parallel_rrt_planner_2d.h>
+
+#include <algorithm>
+#include <limits>
+#include <glog/logging.h>
+
+namespace path {
+
+  // The algorithm. See header for references.
+  Status ParallelRRTPlanner2D::PlanTrajectory(
+                                  const util::Deadline& deadline,
+                                  const util::CancellationToken::Ptr& cancel,
+                                  Trajectory2D::Ptr& path) {
+    CHECK_GT(batch_size_, 0u);
+    const Point2D::Value origin(*origin_);
+    const Point2D::Value goal(*goal_);
+
+    // Check if a path already exists.
+    Node2D::Index goal_index = tree_.Find(goal);
+    if (goal_index != Node2D::kNone) {
+      path = tree_.GetTrajectory(goal_index);
+      return Status::Ok();
+    }
+
+    // Initialize the tree.
+    if (tree_.Size() == 0)
+      tree_.Insert(origin);
+
+    Status status = Status::NotFound("Sample budget exhausted.");
+    for (size_t ii = 0; ii < max_samples_; ii += batch_size_) {
+      if (cancel != nullptr && cancel->IsCancelled()) {
+        status = Status::Cancelled();
+        break;
+      }
+      if (deadline.Expired()) {
+        status = Status::DeadlineExceeded();
+        break;
+      }
+
+      // Sample, step and check concurrently. The tree is only read here.
+      const long batch_size =
+        static_cast<long>(std::min(batch_size_, max_samples_ - ii));
+      const uint64_t first_sample = num_samples_;
+      num_samples_ += batch_size;
+      steps_.resize(batch_size);
+
+#pragma omp parallel for schedule(dynamic, 16)
+      for (long jj = 0; jj < batch_size; jj++) {
+        const Point2D::Value random_point = sampler_->Sample(
+          0, first_sample + jj, std::numeric_limits<float>::infinity());
+
+        const Node2D::Index nearest = tree_.GetNearestIndex(random_point);
+        const Point2D::Value& nearest_point = tree_.GetPoint(nearest);
+
+        Step& step = steps_[jj];
+        step.point =
+          Point2D::StepToward(nearest_point, random_point, step_size_);
+        step.parent = robot_.LineOfSight(nearest_point, step.point) ?
+          nearest : Node2D::kNone;
+        step.sees_goal = step.parent != Node2D::kNone &&
+          robot_.LineOfSight(step.point, goal);
+      }
+
+      // Insert in sample order, stopping once the goal is reached.
+      for (long jj = 0; jj < batch_size; jj++) {
+        const Step& step = steps_[jj];
+        if (step.parent == Node2D::kNone)
+          continue;
+
+        const Node2D::Index step_index = tree_.Insert(step.point, step.parent);
+        if (step_index == Node2D::kNone)
+          continue;
+
+        if (step.sees_goal) {
+          goal_index = tree_.InsertSegment(step_index, goal, step_size_);
+          if (goal_index != Node2D::kNone)
+            break;
+        }
+      }
+
+      if (goal_index != Node2D::kNone) {
+        VLOG(1) << "Reached the goal after " << num_samples_
+                << " samples, with " << tree_.Size() << " nodes.";
+        status = Status::Ok();
+        break;
+      }
+    }
+
+    // Return the trajectory to the goal, or as close to it as we got.
+    if (goal_index == Node2D::kNone)
+      goal_index = tree_.GetNearestIndex(goal);
+    path = tree_.GetTrajectory(goal_index);
+    return status;
+  }
+
+  Trajectory2D::Ptr ParallelRRTPlanner2D::PlanTrajectory() {
+    Trajectory2D::Ptr path;
+    PlanTrajectory(util::Deadline::Never(), nullptr, path);
+    return path;
+  }
+
+  // Set the sampler.
+  void ParallelRRTPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
+
+} //\ namespace path
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines a probabilistic roadmap (PRM) planner, for answering
+// many queries in the same static scene.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/prm_planner_2d.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <glog/logging.h>
+
+namespace path {
+
+  namespace {
+    const int kNoNode = -1;
+  } //\ namespace
+
+  // Build the roadmap.
+  void PRMPlanner2D::BuildRoadmap() {
+    CHECK_GT(max_neighbors_, 0u);
+
+    // Draw samples concurrently, then keep the feasible ones in order.
+    const long num_samples = static_cast<long>(num_samples_);
+    std::vector<Point2D::Value> samples(num_samples);
+    std::vector<uint8_t> feasible(num_samples);
+#pragma omp parallel for schedule(static)
+    for (long ii = 0; ii < num_samples; ii++) {
+      samples[ii] = sampler_->Sample(0, ii,
+                                     std::numeric_limits<float>::infinity());
+      feasible[ii] = robot_.IsFeasible(samples[ii]);
+    }
+
+    points_.clear();
+    for (long ii = 0; ii < num_samples; ii++)
+      if (feasible[ii])
+        points_.push_back(samples[ii]);
+
+    index_.Clear();
+    index_.AddPoints(points_);
+
+    // Candidate edges go to the nearest neighbors within the connection
+    // radius. Slots [ii * k, ii * k + num_candidates[ii]) hold node ii's.
+    const long num_nodes = static_cast<long>(points_.size());
+    const size_t k = max_neighbors_;
+    std::vector<int> offsets, neighbors;
+    index_.RadiusSearch(points_, offsets, neighbors, connection_radius_, true);
+
+    std::vector<int> candidates(num_nodes * k);
+    std::vector<int> num_candidates(num_nodes);
+#pragma omp parallel for schedule(static)
+    for (long ii = 0; ii < num_nodes; ii++) {
+      std::vector< std::pair<float, int> > nearby;
+      for (int jj = offsets[ii]; jj < offsets[ii + 1]; jj++) {
+        if (neighbors[jj] == ii)
+          continue;
+
+        nearby.push_back(std::make_pair(
+          Point2D::DistancePointToPoint(points_[ii], points_[neighbors[jj]]),
+          neighbors[jj]));
+      }
+
+      const size_t num_kept = std::min(nearby.size(), k);
+      std::partial_sort(nearby.begin(), nearby.begin() + num_kept,
+                        nearby.end());
+      for (size_t jj = 0; jj < num_kept; jj++)
+        candidates[ii * k + jj] = nearby[jj].second;
+      num_candidates[ii] = num_kept;
+    }
+
+    // Check each candidate edge once, from the lower numbered end unless
+    // only the higher numbered end chose it. In lazy mode, keep them all
+    // unchecked.
+    std::vector<uint8_t> valid(num_nodes * k, 0);
+#pragma omp parallel for schedule(dynamic, 16)
+    for (long ii = 0; ii < num_nodes; ii++) {
+      for (int jj = 0; jj < num_candidates[ii]; jj++) {
+        const int other = candidates[ii * k + jj];
+        const int* other_begin = &candidates[other * k];
+        const int* other_end = other_begin + num_candidates[other];
+        if (other < ii && std::find(other_begin, other_end, ii) != other_end)
+          continue;
+
+        valid[ii * k + jj] =
+          lazy_ || robot_.LineOfSight(points_[ii], points_[other]);
+      }
+    }
+
+    // Store both directions of every edge.
+    offsets_.assign(num_nodes + 1, 0);
+    for (long ii = 0; ii < num_nodes; ii++) {
+      for (int jj = 0; jj < num_candidates[ii]; jj++) {
+        if (valid[ii * k + jj]) {
+          offsets_[ii + 1]++;
+          offsets_[candidates[ii * k + jj] + 1]++;
+        }
+      }
+    }
+    for (long ii = 0; ii < num_nodes; ii++)
+      offsets_[ii + 1] += offsets_[ii];
+
+    targets_.resize(offsets_[num_nodes]);
+    weights_.resize(offsets_[num_nodes]);
+    std::vector<int> cursor(offsets_.begin(), offsets_.end() - 1);
+    for (long ii = 0; ii < num_nodes; ii++) {
+      for (int jj = 0; jj < num_candidates[ii]; jj++) {
+        if (!valid[ii * k + jj])
+          continue;
+
+        const int other = candidates[ii * k + jj];
+        const float weight =
+          Point2D::DistancePointToPoint(points_[ii], points_[other]);
+        targets_[cursor[ii]] = other;
+        weights_[cursor[ii]++] = weight;
+        targets_[cursor[other]] = ii;
+        weights_[cursor[other]++] = weight;
+      }
+    }
+
+    edge_states_.assign(targets_.size(), lazy_ ? UNCHECKED : VALID);
+
+    // Reset the search state. The last two nodes are the origin and goal.
+    query_.assign(num_nodes + 2, 0);
+    goal_link_.assign(num_nodes + 2, 0);
+    g_.resize(num_nodes + 2);
+    parent_.resize(num_nodes + 2);
+    current_query_ = 0;
+    built_ = true;
+
+    VLOG(1) << "Built a roadmap with " << GetNumNodes() << " nodes and "
+            << GetNumEdges() << " edges.";
+  }
+
+  // The algorithm. See header for references.
+  Status PRMPlanner2D::PlanTrajectory(const Point2D::Value& origin,
+                                      const Point2D::Value& goal,
+                                      Trajectory2D::Ptr& path) {
+    cost_ = std::numeric_limits<float>::infinity();
+    if (!robot_.IsFeasible(origin) || !robot_.IsFeasible(goal))
+      return Status::FailedPrecondition("Endpoint is infeasible.");
+
+    // Trivial plan.
+    if (robot_.LineOfSight(origin, goal)) {
+      std::vector<Point2D::Value> points;
+      points.push_back(origin);
+      points.push_back(goal);
+      cost_ = Point2D::DistancePointToPoint(origin, goal);
+      path = Trajectory2D::Create(points);
+      return Status::Ok();
+    }
+
+    if (!built_)
+      BuildRoadmap();
+
+    Connect(origin, origin_links_);
+    Connect(goal, goal_links_);
+
+    // Search until a path survives its checks. Each failed check removes
+    // an edge, so this ends.
+    size_t num_searches = 1;
+    while (Search(origin, goal) && !ValidatePath())
+      num_searches++;
+
+    const int origin_node = static_cast<int>(points_.size());
+    const int goal_node = origin_node + 1;
+    if (query_[goal_node] != current_query_) {
+      VLOG(1) << "No path found after " << num_searches << " searches.";
+      return Status::NotFound("Goal is not connected to the origin.");
+    }
+
+    VLOG(1) << "Found a path after " << num_searches << " searches.";
+    cost_ = g_[goal_node];
+
+    std::vector<Point2D::Value> points;
+    points.push_back(goal);
+    for (int node = parent_[goal_node]; node != origin_node;
+         node = parent_[node])
+      points.push_back(points_[node]);
+    points.push_back(origin);
+    std::reverse(points.begin(), points.end());
+
+    path = Trajectory2D::Create(points);
+    return Status::Ok();
+  }
+
+  // A* over the roadmap.
+  bool PRMPlanner2D::Search(const Point2D::Value& origin,
+                            const Point2D::Value& goal) {
+    // Start a new query. Stale values from earlier queries are ignored
+    // because their tags no longer match; on wraparound, clear the tags.
+    if (++current_query_ == 0) {
+      std::fill(query_.begin(), query_.end(), 0);
+      std::fill(goal_link_.begin(), goal_link_.end(), 0);
+      current_query_ = 1;
+    }
+
+    const int origin_node = static_cast<int>(points_.size());
+    const int goal_node = origin_node + 1;
+    for (size_t ii = 0; ii < goal_links_.size(); ii++)
+      goal_link_[goal_links_[ii]] = current_query_;
+
+    // Seed the open list with the origin's links.
+    open_.clear();
+    query_[origin_node] = current_query_;
+    g_[origin_node] = 0.0;
+    parent_[origin_node] = kNoNode;
+    for (size_t ii = 0; ii < origin_links_.size(); ii++) {
+      const int node = origin_links_[ii];
+      Entry entry;
+      entry.g = Point2D::DistancePointToPoint(origin, points_[node]);
+      entry.f = entry.g + Point2D::DistancePointToPoint(points_[node], goal);
+      entry.node = node;
+      query_[node] = current_query_;
+      g_[node] = entry.g;
+      parent_[node] = origin_node;
+      open_.push_back(entry);
+    }
+    std::make_heap(open_.begin(), open_.end(), std::greater<Entry>());
+
+    while (!open_.empty()) {
+      std::pop_heap(open_.begin(), open_.end(), std::greater<Entry>());
+      const Entry entry = open_.back();
+      open_.pop_back();
+      if (entry.g > g_[entry.node])
+        continue;
+      if (entry.node == goal_node)
+        return true;
+
+      const int node = entry.node;
+
+      // Relax a neighbor, including the goal.
+      auto relax = [&](int next, const Point2D::Value& point, float weight) {
+        const float g = entry.g + weight;
+        if (query_[next] == current_query_ && g_[next] <= g)
+          return;
+
+        query_[next] = current_query_;
+        g_[next] = g;
+        parent_[next] = node;
+
+        Entry next_entry;
+        next_entry.g = g;
+        next_entry.f = g + Point2D::DistancePointToPoint(point, goal);
+        next_entry.node = next;
+        open_.push_back(next_entry);
+        std::push_heap(open_.begin(), open_.end(), std::greater<Entry>());
+      };
+
+      for (int ii = offsets_[node]; ii < offsets_[node + 1]; ii++) {
+        if (edge_states_[ii] != BLOCKED)
+          relax(targets_[ii], points_[targets_[ii]], weights_[ii]);
+      }
+      if (goal_link_[node] == current_query_)
+        relax(goal_node, goal,
+              Point2D::DistancePointToPoint(points_[node], goal));
+    }
+
+    return false;
+  }
+
+  // Check the roadmap edges of the path just found.
+  bool PRMPlanner2D::ValidatePath() {
+    const int origin_node = static_cast<int>(points_.size());
+    const int goal_node = origin_node + 1;
+
+    // The links to the endpoints were checked by Connect().
+    bool valid = true;
+    for (int node = parent_[goal_node]; parent_[node] != origin_node;
+         node = parent_[node]) {
+      const int parent = parent_[node];
+      const int edge = FindEdge(node, parent);
+      if (edge_states_[edge] != UNCHECKED)
+        continue;
+
+      const EdgeState state =
+        robot_.LineOfSight(points_[node], points_[parent]) ? VALID : BLOCKED;
+      edge_states_[edge] = state;
+      edge_states_[FindEdge(parent, node)] = state;
+      valid &= (state == VALID);
+    }
+
+    return valid;
+  }
+
+  // Find an edge in the CSR arrays.
+  int PRMPlanner2D::FindEdge(int node, int other) const {
+    const int* begin = &targets_[0] + offsets_[node];
+    const int* end = &targets_[0] + offsets_[node + 1];
+    const int* edge = std::find(begin, end, other);
+    CHECK(edge != end);
+    return edge - &targets_[0];
+  }
+
+  // Set the sampler.
+  void PRMPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
+
+  // Find the roadmap nodes to join a point to.
+  void PRMPlanner2D::Connect(const Point2D::Value& point,
+                             std::vector<int>& nodes) {
+    nodes.clear();
+    if (points_.empty())
+      return;
+
+    std::vector< std::pair<float, int> > nearby;
+    index_.RadiusVisit(point, connection_radius_, [&](int index) {
+      nearby.push_back(std::make_pair(
+        Point2D::DistancePointToPoint(point, points_[index]), index));
+    });
+    std::sort(nearby.begin(), nearby.end());
+
+    for (size_t ii = 0; ii < nearby.size() && nodes.size() < max_neighbors_;
+         ii++) {
+      if (robot_.LineOfSight(point, points_[nearby[ii].second]))
+        nodes.push_back(nearby[ii].second);
+    }
+
+    if (nearby.empty()) {
+      int nearest;
+      float distance;
+      if (index_.NearestNeighbor(point, nearest, distance) &&
+          robot_.LineOfSight(point, points_[nearest]))
+        nodes.push_back(nearest);
+    }
+  }
+
+} //\ namespace path
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines the RRT-Connect planner, which grows one tree from the
+// origin and one from the goal and greedily tries to join them:
+// + http://www.kuffner.org/james/papers/kuffner_icra2000.pdf
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/rrt_connect_planner_2d.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <glog/logging.h>
+
+namespace path {
+
+  // The algorithm. See header for references.
+  Status RRTConnectPlanner2D::PlanTrajectory(
+                                  const util::Deadline& deadline,
+                                  const util::CancellationToken::Ptr& cancel,
+                                  Trajectory2D::Ptr& path) {
+    const Point2D::Value origin(*origin_);
+    const Point2D::Value goal(*goal_);
+
+    // Trivial plan.
+    if (origin.x == goal.x && origin.y == goal.y)
+      path_ = Trajectory2D::Create(std::vector<Point2D::Value>(1, origin));
+
+    // Check if the trees have already met.
+    if (path_ != nullptr) {
+      path = path_;
+      return Status::Ok();
+    }
+
+    if (origin_tree_.Size() == 0)
+      origin_tree_.Insert(origin);
+    if (goal_tree_.Size() == 0)
+      goal_tree_.Insert(goal);
+
+    // Trees swap roles every sample; 'tree' is extended toward the sample
+    // and 'other' tries to connect to the new node.
+    RRT2D* tree = (num_samples_ % 2 == 0) ? &origin_tree_ : &goal_tree_;
+    RRT2D* other = (num_samples_ % 2 == 0) ? &goal_tree_ : &origin_tree_;
+    Status status = Status::NotFound("Sample budget exhausted.");
+    for (size_t ii = 0; ii < max_samples_; ii++) {
+      if (cancel != nullptr && cancel->IsCancelled()) {
+        status = Status::Cancelled();
+        break;
+      }
+      if (deadline.Expired()) {
+        status = Status::DeadlineExceeded();
+        break;
+      }
+
+      const Point2D::Value sample = sampler_->Sample(
+        0, num_samples_++, std::numeric_limits<float>::infinity());
+
+      Node2D::Index new_index;
+      if (Extend(*tree, sample, new_index) != TRAPPED) {
+        Node2D::Index other_index;
+        if (Connect(*other, tree->GetPoint(new_index), other_index) ==
+            REACHED) {
+          // Both trees now hold a node at the same point. Join the origin
+          // tree's path to it with the reversed goal tree path.
+          const bool from_origin = (tree == &origin_tree_);
+          Trajectory2D::Ptr head = origin_tree_.GetTrajectory(
+            from_origin ? new_index : other_index);
+          Trajectory2D::Ptr tail = goal_tree_.GetTrajectory(
+            from_origin ? other_index : new_index);
+
+          std::vector<Point2D::Value> points;
+          points.reserve(head->Size() + tail->Size());
+          for (size_t jj = 0; jj < head->Size(); jj++)
+            points.push_back(Point2D::Value(head->GetX()[jj],
+                                            head->GetY()[jj]));
+          for (size_t jj = tail->Size() - 1; jj-- > 0; )
+            points.push_back(Point2D::Value(tail->GetX()[jj],
+                                            tail->GetY()[jj]));
+
+          VLOG(1) << "Trees connected after " << num_samples_
+                  << " samples, with "
+                  << origin_tree_.Size() + goal_tree_.Size() << " nodes.";
+          path_ = Trajectory2D::Create(points);
+          path = path_;
+          return Status::Ok();
+        }
+      }
+
+      std::swap(tree, other);
+    }
+
+    VLOG(1) << "Trees did not connect after " << num_samples_ << " samples.";
+    path = origin_tree_.GetTrajectory(origin_tree_.GetNearestIndex(goal));
+    return status;
+  }
+
+  Trajectory2D::Ptr RRTConnectPlanner2D::PlanTrajectory() {
+    Trajectory2D::Ptr path;
+    PlanTrajectory(util::Deadline::Never(), nullptr, path);
+    return path;
+  }
+
+  // Set the sampler.
+  void RRTConnectPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
+
+  // Take one step from the nearest node toward the target.
+  RRTConnectPlanner2D::ExtendResult RRTConnectPlanner2D::Extend(
+                                              RRT2D& tree,
+                                              const Point2D::Value& target,
+                                              Node2D::Index& index) {
+    const Node2D::Index nearest = tree.GetNearestIndex(target);
+    const Point2D::Value nearest_point = tree.GetPoint(nearest);
+
+    const Point2D::Value step =
+      Point2D::StepToward(nearest_point, target, step_size_);
+    if (!robot_.LineOfSight(nearest_point, step))
+      return TRAPPED;
+
+    index = tree.Insert(step, nearest);
+    if (index == Node2D::kNone)
+      return TRAPPED;
+
+    return (step.x == target.x && step.y == target.y) ? REACHED : ADVANCED;
+  }
+
+  // Step toward the target until reaching it or getting trapped.
+  RRTConnectPlanner2D::ExtendResult RRTConnectPlanner2D::Connect(
+                                              RRT2D& tree,
+                                              const Point2D::Value& target,
+                                              Node2D::Index& index) {
+    ExtendResult result = Extend(tree, target, index);
+    while (result == ADVANCED)
+      result = Extend(tree, target, index);
+
+    return result;
+  }
+
+} //\ namespace path
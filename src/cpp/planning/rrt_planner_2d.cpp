@@ -46,64 +46,170 @@
 #include <planning/rrt_planner_2d.h>
 
 #include <iostream>
+#include <cmath>
+#include <limits>
 #include <glog/logging.h>
 
 namespace path {
 
   // The algorithm. See header for references.
-  Trajectory2D::Ptr RRTPlanner2D::PlanTrajectory() {
+  Status RRTPlanner2D::PlanTrajectory(const util::Deadline& deadline,
+                                      const util::CancellationToken::Ptr& cancel,
+                                      Trajectory2D::Ptr& path) {
+    const Point2D::Value origin(*origin_);
+    const Point2D::Value goal(*goal_);
 
     // Check if a path already exists.
-    if (tree_.Contains(goal_))
-      return tree_.GetTrajectory(goal_);
+    Node2D::Index goal_index = tree_.Find(goal);
+    if (goal_index != Node2D::kNone) {
+      path = tree_.GetTrajectory(goal_index);
+      return Status::Ok();
+    }
 
     // Initialize the tree.
-    tree_.Insert(origin_);
+    if (tree_.Size() == 0)
+      Insert(origin, Node2D::kNone, true);
 
     // Algorithm:
     // 1. Choose a random point.
     // 2. Take a step toward that point if possible.
-    Point2D::Ptr last_point;
-    while (!tree_.Contains(goal_) && tree_.Size() < 10000) {
+    Status status = Status::NotFound("Sample budget exhausted.");
+    for (size_t ii = 0; ii < max_samples_; ii++) {
+      if (cancel != nullptr && cancel->IsCancelled()) {
+        status = Status::Cancelled();
+        break;
+      }
+      if (deadline.Expired()) {
+        status = Status::DeadlineExceeded();
+        break;
+      }
+
       // Pick a random point in the scene.
-      Point2D::Ptr random_point = scene_.GetRandomPoint();
+      Point2D::Value random_point = sampler_->Sample(
+        0, num_samples_++, std::numeric_limits<float>::infinity());
 
       // Find nearest point in the tree.
-      Point2D::Ptr nearest = tree_.GetNearest(random_point);
+      Node2D::Index nearest = tree_.GetNearestIndex(random_point);
+      const Point2D::Value nearest_point = tree_.GetPoint(nearest);
+
+      // Take a step toward the random point. In lazy mode, only the new
+      // point is checked.
+      Point2D::Value step =
+        Point2D::StepToward(nearest_point, random_point, step_size_);
+      if (lazy_ ? !robot_.IsFeasible(step) :
+          !robot_.LineOfSight(nearest_point, step))
+        continue;
+
+      Node2D::Index step_index = Insert(step, nearest, !lazy_);
+      if (step_index == Node2D::kNone) {
+        VLOG(1) << "Could not insert this point. Skipping.";
+        continue;
+      }
 
-      // Take a step toward the random point.
-      Point2D::Ptr step = Point2D::StepToward(nearest, random_point, step_size_);
-      if (robot_.LineOfSight(nearest, step)) {
-        if (!tree_.Insert(step))
-          VLOG(1) << "Could not insert this point. Skipping.";
+      // In lazy mode, join the goal if it is within a step, then check the
+      // whole path to it.
+      if (lazy_) {
+        if (Point2D::DistancePointToPoint(step, goal) > step_size_)
+          continue;
 
-        last_point = step;
+        goal_index = Insert(goal, step_index, false);
+        if (goal_index != Node2D::kNone && Validate(goal_index) == goal_index) {
+          status = Status::Ok();
+          break;
+        }
+
+        goal_index = Node2D::kNone;
+        continue;
       }
 
-      // Insert the goal (stepwise) if it is visible.
-      if (robot_.LineOfSight(step, goal_)) {
-        float distance_to_goal = Point2D::DistancePointToPoint(step, goal_);
-        int num_steps = static_cast<int>(std::ceil(distance_to_goal / step_size_));
+      // Insert the goal (stepwise) if it is visible. Every edge on the way
+      // lies on the segment just checked.
+      if (robot_.LineOfSight(step, goal)) {
+        goal_index = tree_.InsertSegment(step_index, goal, step_size_);
+        checked_.resize(tree_.Size(), true);
+        if (goal_index == Node2D::kNone) {
+          VLOG(1) << "Error. Could not insert the goal point.";
+        } else {
+          status = Status::Ok();
+          break;
+        }
+      }
+    }
 
-        for (int ii = 0; ii < num_steps - 1; ii++) {
-          Point2D::Ptr next = Point2D::StepToward(step, goal_, step_size_);
+    // Return the trajectory to the goal, or as close to it as we got.
+    if (goal_index == Node2D::kNone) {
+      goal_index = tree_.GetNearestIndex(goal);
+      if (lazy_)
+        goal_index = Validate(goal_index);
+    }
+    path = tree_.GetTrajectory(goal_index);
+    return status;
+  }
 
-          if (!tree_.Insert(next, step))
-            VLOG(1) << "Error. Could not insert a point.";
+  Trajectory2D::Ptr RRTPlanner2D::PlanTrajectory() {
+    Trajectory2D::Ptr path;
+    PlanTrajectory(util::Deadline::Never(), nullptr, path);
+    return path;
+  }
 
-          step = next;
-        }
+  // Set the sampler.
+  void RRTPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
 
-        // Insert the goal point at the end.
-        if (!tree_.Insert(goal_, step))
-          VLOG(1) << "Error. Could not insert the goal point.";
+  // Insert a node.
+  Node2D::Index RRTPlanner2D::Insert(const Point2D::Value& point,
+                                     Node2D::Index parent, bool checked) {
+    const Node2D::Index index = (parent == Node2D::kNone) ?
+      tree_.Insert(point) : tree_.Insert(point, parent);
+    if (index != Node2D::kNone) {
+      CHECK_EQ(index, checked_.size());
+      checked_.push_back(checked);
+    }
+
+    return index;
+  }
 
-        last_point = goal_;
+  // Check the path to a node, pruning at the first blocked edge.
+  Node2D::Index RRTPlanner2D::Validate(Node2D::Index index) {
+    path_.clear();
+    for (Node2D::Index node = index; node != Node2D::kNone;
+         node = tree_.GetNode(node).parent)
+      path_.push_back(node);
+
+    // path_ runs from 'index' up to the root, whose edge needs no check.
+    for (size_t ii = path_.size() - 1; ii-- > 0; ) {
+      const Node2D::Index child = path_[ii];
+      const Node2D::Index parent = path_[ii + 1];
+      if (checked_[child])
+        continue;
+
+      if (robot_.LineOfSight(tree_.GetPoint(parent), tree_.GetPoint(child))) {
+        checked_[child] = true;
+        continue;
       }
+
+      // Prune the subtree below the blocked edge. Reuse path_ as the stack,
+      // since the rest of the path is no longer needed.
+      size_t num_removed = 0;
+      path_.assign(1, child);
+      while (!path_.empty()) {
+        const Node2D::Index node = path_.back();
+        path_.pop_back();
+        for (Node2D::Index next = tree_.GetNode(node).first_child;
+             next != Node2D::kNone; next = tree_.GetNode(next).next_sibling)
+          path_.push_back(next);
+
+        tree_.Remove(node);
+        num_removed++;
+      }
+
+      VLOG(1) << "Pruned " << num_removed << " nodes below a blocked edge.";
+      return parent;
     }
 
-    // Return the trajectory.
-    return tree_.GetTrajectory(last_point);
+    return index;
   }
 
 } //\ namespace path
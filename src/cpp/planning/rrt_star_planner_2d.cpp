@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file defines the RRT* planner, which grows a single tree from the
+// origin and rewires it as it grows so that paths approach the shortest:
+// + http://arxiv.org/abs/1105.1186
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <planning/rrt_star_planner_2d.h>
+#include <planning/uniform_sampler_2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glog/logging.h>
+
+namespace path {
+
+  RRTStarPlanner2D::RRTStarPlanner2D(Robot2DCircular& robot,
+                                     Scene2DContinuous& scene,
+                                     Point2D::Ptr origin, Point2D::Ptr goal,
+                                     float step_size, size_t max_samples,
+                                     float gamma, size_t max_neighbors)
+    : robot_(robot), scene_(scene),
+      origin_(origin), goal_(goal),
+      sampler_(UniformSampler2D::Create(scene)),
+      goal_index_(Node2D::kNone),
+      num_samples_(0),
+      step_size_(step_size),
+      max_samples_(max_samples),
+      gamma_(gamma),
+      max_neighbors_(max_neighbors) {
+    CHECK_NOTNULL(origin_.get());
+    CHECK_NOTNULL(goal_.get());
+    CHECK_GT(max_neighbors_, 0u);
+  }
+
+  // The algorithm. See header for references.
+  Status RRTStarPlanner2D::PlanTrajectory(
+                                  const util::Deadline& deadline,
+                                  const util::CancellationToken::Ptr& cancel,
+                                  Trajectory2D::Ptr& path) {
+    const Point2D::Value origin(*origin_);
+    const Point2D::Value goal(*goal_);
+
+    // Trivial plan.
+    if (origin.x == goal.x && origin.y == goal.y) {
+      path = Trajectory2D::Create(std::vector<Point2D::Value>(1, origin));
+      return Status::Ok();
+    }
+
+    if (tree_.Size() == 0) {
+      tree_.Insert(origin);
+      cost_.push_back(0.0);
+    }
+
+    Status status = Status::Ok();
+    for (size_t ii = 0; ii < max_samples_; ii++) {
+      if (cancel != nullptr && cancel->IsCancelled()) {
+        status = Status::Cancelled();
+        break;
+      }
+      if (deadline.Expired()) {
+        status = Status::DeadlineExceeded();
+        break;
+      }
+
+      const Point2D::Value sample =
+        sampler_->Sample(0, num_samples_++, GetBestCost());
+
+      const Node2D::Index nearest = tree_.GetNearestIndex(sample);
+      const Point2D::Value step =
+        Point2D::StepToward(tree_.GetPoint(nearest), sample, step_size_);
+      if (tree_.Contains(step))
+        continue;
+
+      const Node2D::Index index = Insert(step, nearest);
+      if (index == Node2D::kNone || goal_index_ != Node2D::kNone)
+        continue;
+
+      // The goal joins the tree as soon as it is within a step of a node.
+      // From then on, rewiring shortens its path like any other node's.
+      if (step.x == goal.x && step.y == goal.y) {
+        goal_index_ = index;
+      } else if (Point2D::DistancePointToPoint(step, goal) <= step_size_) {
+        goal_index_ = Insert(goal, tree_.GetNearestIndex(goal));
+      }
+
+      if (goal_index_ != Node2D::kNone) {
+        VLOG(1) << "Reached the goal after " << num_samples_
+                << " samples, with cost " << cost_[goal_index_] << ".";
+      }
+    }
+
+    if (goal_index_ == Node2D::kNone) {
+      VLOG(1) << "Did not reach the goal after " << num_samples_
+              << " samples.";
+      if (status.ok())
+        status = Status::NotFound("Goal not reached.");
+      path = tree_.GetTrajectory(tree_.GetNearestIndex(goal));
+      return status;
+    }
+
+    path = tree_.GetTrajectory(goal_index_);
+    return status;
+  }
+
+  Trajectory2D::Ptr RRTStarPlanner2D::PlanTrajectory() {
+    Trajectory2D::Ptr path;
+    PlanTrajectory(util::Deadline::Never(), nullptr, path);
+    return path;
+  }
+
+  // Set the sampler.
+  void RRTStarPlanner2D::SetSampler(Sampler2D::Ptr sampler) {
+    CHECK_NOTNULL(sampler.get());
+    sampler_ = sampler;
+  }
+
+  // Length of the best path to the goal so far.
+  float RRTStarPlanner2D::GetBestCost() const {
+    if (goal_index_ == Node2D::kNone)
+      return std::numeric_limits<float>::infinity();
+
+    return cost_[goal_index_];
+  }
+
+  // Number of nodes in the tree.
+  int RRTStarPlanner2D::GetTreeSize() const {
+    return tree_.Size();
+  }
+
+  // Insert a point under its cheapest visible neighbor and rewire the rest.
+  Node2D::Index RRTStarPlanner2D::Insert(const Point2D::Value& point,
+                                         Node2D::Index nearest) {
+    // Gather neighbors. The radius always reaches the nearest node, so there
+    // is at least one candidate parent.
+    const float radius = std::max(NeighborRadius(),
+      Point2D::DistancePointToPoint(tree_.GetPoint(nearest), point));
+    tree_.RadiusSearch(point, radius, neighbors_);
+
+    candidates_.clear();
+    for (Node2D::Index neighbor : neighbors_) {
+      Candidate candidate;
+      candidate.index = neighbor;
+      candidate.distance =
+        Point2D::DistancePointToPoint(tree_.GetPoint(neighbor), point);
+      candidate.cost = cost_[neighbor] + candidate.distance;
+      candidate.visible = -1;
+      candidates_.push_back(candidate);
+    }
+
+    // Keep only the closest neighbors.
+    if (candidates_.size() > max_neighbors_) {
+      std::nth_element(candidates_.begin(),
+                       candidates_.begin() + max_neighbors_,
+                       candidates_.end(),
+                       [](const Candidate& a, const Candidate& b) {
+                         return a.distance < b.distance;
+                       });
+      candidates_.resize(max_neighbors_);
+    }
+
+    // The parent is the cheapest candidate that can see the point. Checking
+    // in order of cost means that no edge past the parent is checked here.
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) {
+                return a.cost < b.cost;
+              });
+
+    size_t parent = candidates_.size();
+    for (size_t ii = 0; ii < candidates_.size(); ii++) {
+      candidates_[ii].visible =
+        robot_.LineOfSight(tree_.GetPoint(candidates_[ii].index), point);
+      if (candidates_[ii].visible) {
+        parent = ii;
+        break;
+      }
+    }
+
+    if (parent == candidates_.size())
+      return Node2D::kNone;
+
+    const Node2D::Index index =
+      tree_.Insert(point, candidates_[parent].index);
+    if (index == Node2D::kNone)
+      return Node2D::kNone;
+    cost_.push_back(candidates_[parent].cost);
+
+    // Rewire neighbors through the new node. Candidates before the parent
+    // are known to be blocked, and an edge is only checked if it shortens
+    // the neighbor's path. Costs are read fresh, since an earlier rewire
+    // may have moved a neighbor's ancestor.
+    for (size_t ii = parent + 1; ii < candidates_.size(); ii++) {
+      Candidate& candidate = candidates_[ii];
+      const float cost = cost_[index] + candidate.distance;
+      if (cost >= cost_[candidate.index])
+        continue;
+
+      if (candidate.visible < 0)
+        candidate.visible =
+          robot_.LineOfSight(point, tree_.GetPoint(candidate.index));
+      if (candidate.visible)
+        Rewire(candidate.index, index, cost);
+    }
+
+    return index;
+  }
+
+  // Move a node under a new parent and update its subtree.
+  void RRTStarPlanner2D::Rewire(Node2D::Index index, Node2D::Index parent,
+                                float cost) {
+    const float delta = cost - cost_[index];
+    tree_.SetParent(index, parent);
+
+    // Shift the cost of every node in the subtree by the same amount.
+    stack_.clear();
+    stack_.push_back(index);
+    while (!stack_.empty()) {
+      const Node2D::Index node = stack_.back();
+      stack_.pop_back();
+
+      cost_[node] += delta;
+      for (Node2D::Index child = tree_.GetNode(node).first_child;
+           child != Node2D::kNone;
+           child = tree_.GetNode(child).next_sibling)
+        stack_.push_back(child);
+    }
+  }
+
+  // Neighbor radius for the current tree size.
+  float RRTStarPlanner2D::NeighborRadius() const {
+    const float size = static_cast<float>(tree_.Size());
+    if (size < 2.0)
+      return step_size_;
+
+    return std::min(step_size_, gamma_ * std::sqrt(std::log(size) / size));
+  }
+
+} //\ namespace path
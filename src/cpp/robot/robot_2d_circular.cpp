@@ -48,18 +48,41 @@
 namespace path {
 
   // Test if a particular robot location is feasible.
-  bool Robot2DCircular::IsFeasible(Point2D::Ptr location) {
+  bool Robot2DCircular::IsFeasible(Point2D::Ptr location) const {
     CHECK_NOTNULL(location.get());
+    return IsFeasible(Point2D::Value(*location));
+  }
+
+  bool Robot2DCircular::IsFeasible(const Point2D::Value& location) const {
+    // Check every obstacle within its own radius of the robot's bounding
+    // sphere, not just the nearest center: a large obstacle can cover the
+    // point while a smaller one is closer.
+    bool feasible = true;
+    scene_.VisitObstacles(location, radius_, 1.0,
+                          [&](const Obstacle2D& obstacle) {
+        if (feasible &&
+            Point2D::DistancePointToPoint(location,
+                                          obstacle.GetLocationValue()) <
+            obstacle.GetRadius() + radius_)
+          feasible = false;
+      });
 
-    // Find nearest obstacle.
-    Obstacle2D::Ptr nearest;
-    float nn_distance = -1.0;
-    if (!scene_.GetObstacleTree().NearestNeighbor(location, nearest,
-                                                  nn_distance))
-      return false;
+    return feasible;
+  }
+
+  // Test every waypoint of a trajectory, spreading them across cores if
+  // 'parallel' is set.
+  bool Robot2DCircular::IsFeasible(const Trajectory2D& path,
+                                   bool parallel) const {
+    const long num_waypoints = static_cast<long>(path.Size());
+    int num_infeasible = 0;
+#pragma omp parallel for reduction(+:num_infeasible) if (parallel)
+    for (long ii = 0; ii < num_waypoints; ii++) {
+      if (!IsFeasible(path.GetValueAt(ii)))
+        num_infeasible++;
+    }
 
-    // Check that it is outside the bounding sphere.
-    return nn_distance > radius_ + nearest->GetRadius();;
+    return num_infeasible == 0;
   }
 
   // Check if there is a valid linear trajectory between these two points.
@@ -67,29 +90,28 @@ namespace path {
                                     Point2D::Ptr point2) const {
     CHECK_NOTNULL(point1.get());
     CHECK_NOTNULL(point2.get());
+    return LineOfSight(Point2D::Value(*point1), Point2D::Value(*point2));
+  }
 
-    // Check if line segment intersects any nearby obstacle.
-    Point2D::Ptr midpoint = Point2D::MidPoint(point1, point2);
+  bool Robot2DCircular::LineOfSight(const Point2D::Value& point1,
+                                    const Point2D::Value& point2) const {
+    // Check if line segment intersects any nearby obstacle. Only obstacles
+    // within their own radius of the ball around the segment can touch it.
+    Point2D::Value midpoint = Point2D::MidPoint(point1, point2);
     float max_distance =
-      radius_ + scene_.GetLargestObstacleRadius() +
-      0.5 * Point2D::DistancePointToPoint(point1, point2);
-
-    FlannObstacle2DTree& obstacle_tree = scene_.GetObstacleTree();
-    std::vector<Obstacle2D::Ptr> obstacles;
-    if (!obstacle_tree.RadiusSearch(midpoint, obstacles, max_distance)) {
-      VLOG(1) << "Radius search failed during LineOfSight() test. "
-              << "Returning false.";
-      return false;
-    }
+      radius_ + 0.5 * Point2D::DistancePointToPoint(point1, point2);
 
-    for (const auto& obstacle : obstacles) {
-      if (Point2D::DistanceLineToPoint(point1, point2,
-                                       obstacle->GetLocation()) <
-          obstacle->GetRadius() + radius_)
-        return false;
-    }
+    bool line_of_sight = true;
+    scene_.VisitObstacles(midpoint, max_distance, 1.0,
+                          [&](const Obstacle2D& obstacle) {
+        if (line_of_sight &&
+            Point2D::DistanceLineToPoint(point1, point2,
+                                         obstacle.GetLocationValue()) <
+            obstacle.GetRadius() + radius_)
+          line_of_sight = false;
+      });
 
-    return true;
+    return line_of_sight;
   }
 
 } // \namespace path
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class caches a cost field and its gradient on a lazily rasterized,
+// tiled grid over a rectangular region.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <scene/cost_field_2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <glog/logging.h>
+
+namespace path {
+
+  CostField2D::CostField2D(float xmin, float xmax, float ymin, float ymax,
+                           float resolution, int tile_size,
+                           const Evaluator& evaluator)
+    : xmin_(xmin), ymin_(ymin),
+      resolution_(resolution),
+      tile_size_(tile_size),
+      evaluator_(evaluator) {
+    CHECK_GT(resolution_, 0.0);
+    CHECK_GT(tile_size_, 0);
+    CHECK(evaluator_);
+
+    num_cells_x_ = std::max(1, static_cast<int>(
+      std::ceil((xmax - xmin) / resolution_)));
+    num_cells_y_ = std::max(1, static_cast<int>(
+      std::ceil((ymax - ymin) / resolution_)));
+    num_tiles_x_ = (num_cells_x_ + tile_size_ - 1) / tile_size_;
+    num_tiles_y_ = (num_cells_y_ + tile_size_ - 1) / tile_size_;
+
+    tiles_.reset(new std::atomic<Sample*>[num_tiles_x_ * num_tiles_y_]);
+    for (int ii = 0; ii < num_tiles_x_ * num_tiles_y_; ii++)
+      tiles_[ii].store(nullptr);
+  }
+
+  CostField2D::~CostField2D() {
+    Clear();
+  }
+
+  // Interpolated cost, and optionally its derivative, at a point.
+  float CostField2D::Cost(const Point2D::Value& point,
+                          Point2D::Value* derivative) const {
+    const float fx = (point.x - xmin_) / resolution_;
+    const float fy = (point.y - ymin_) / resolution_;
+
+    // Outside the cached region.
+    if (!(fx >= 0.0 && fx <= num_cells_x_ && fy >= 0.0 && fy <= num_cells_y_))
+      return evaluator_(point, derivative);
+
+    // Cell and offset within it.
+    const int cell_x = std::min(static_cast<int>(fx), num_cells_x_ - 1);
+    const int cell_y = std::min(static_cast<int>(fy), num_cells_y_ - 1);
+    const float u = fx - static_cast<float>(cell_x);
+    const float v = fy - static_cast<float>(cell_y);
+
+    const int tile_x = cell_x / tile_size_;
+    const int tile_y = cell_y / tile_size_;
+    const int stride = tile_size_ + 1;
+    const Sample* row0 = GetTile(tile_x, tile_y) +
+      (cell_y - tile_y * tile_size_) * stride + (cell_x - tile_x * tile_size_);
+    const Sample* row1 = row0 + stride;
+
+    const float w00 = (1.0 - u) * (1.0 - v);
+    const float w10 = u * (1.0 - v);
+    const float w01 = (1.0 - u) * v;
+    const float w11 = u * v;
+
+    if (derivative != nullptr) {
+      derivative->x = w00 * row0[0].dx + w10 * row0[1].dx +
+        w01 * row1[0].dx + w11 * row1[1].dx;
+      derivative->y = w00 * row0[0].dy + w10 * row0[1].dy +
+        w01 * row1[0].dy + w11 * row1[1].dy;
+    }
+
+    return w00 * row0[0].cost + w10 * row0[1].cost +
+      w01 * row1[0].cost + w11 * row1[1].cost;
+  }
+
+  // Drop every tile with a sample within 'radius' of 'center'.
+  void CostField2D::Invalidate(const Point2D::Value& center, float radius) {
+    const float tile_extent = resolution_ * tile_size_;
+    const int tile_x_begin = std::max(0, static_cast<int>(
+      std::floor((center.x - radius - xmin_) / tile_extent)));
+    const int tile_x_end = std::min(num_tiles_x_ - 1, static_cast<int>(
+      std::floor((center.x + radius - xmin_) / tile_extent)));
+    const int tile_y_begin = std::max(0, static_cast<int>(
+      std::floor((center.y - radius - ymin_) / tile_extent)));
+    const int tile_y_end = std::min(num_tiles_y_ - 1, static_cast<int>(
+      std::floor((center.y + radius - ymin_) / tile_extent)));
+
+    // Samples on a tile's far edge are shared with the next tile, so widen
+    // the range by one tile on the low side.
+    for (int ty = std::max(0, tile_y_begin - 1); ty <= tile_y_end; ty++) {
+      for (int tx = std::max(0, tile_x_begin - 1); tx <= tile_x_end; tx++)
+        delete[] tiles_[ty * num_tiles_x_ + tx].exchange(nullptr);
+    }
+  }
+
+  // Drop every tile.
+  void CostField2D::Clear() {
+    for (int ii = 0; ii < num_tiles_x_ * num_tiles_y_; ii++)
+      delete[] tiles_[ii].exchange(nullptr);
+  }
+
+  // Grid parameters.
+  float CostField2D::GetResolution() const {
+    return resolution_;
+  }
+
+  int CostField2D::GetTileSize() const {
+    return tile_size_;
+  }
+
+  // Number of tiles currently rasterized.
+  int CostField2D::NumCachedTiles() const {
+    int count = 0;
+    for (int ii = 0; ii < num_tiles_x_ * num_tiles_y_; ii++)
+      count += (tiles_[ii].load() != nullptr);
+    return count;
+  }
+
+  // Rasterize one tile.
+  CostField2D::Sample* CostField2D::Rasterize(int tile_x, int tile_y) const {
+    const int stride = tile_size_ + 1;
+    Sample* samples = new Sample[stride * stride];
+
+    for (int jj = 0; jj < stride; jj++) {
+      const float y = ymin_ + resolution_ * (tile_y * tile_size_ + jj);
+      for (int ii = 0; ii < stride; ii++) {
+        const float x = xmin_ + resolution_ * (tile_x * tile_size_ + ii);
+
+        Point2D::Value derivative;
+        Sample& sample = samples[jj * stride + ii];
+        sample.cost = evaluator_(Point2D::Value(x, y), &derivative);
+        sample.dx = derivative.x;
+        sample.dy = derivative.y;
+      }
+    }
+
+    return samples;
+  }
+
+  // Get a tile, rasterizing it if needed.
+  const CostField2D::Sample* CostField2D::GetTile(int tile_x,
+                                                  int tile_y) const {
+    std::atomic<Sample*>& slot = tiles_[tile_y * num_tiles_x_ + tile_x];
+    Sample* tile = slot.load(std::memory_order_acquire);
+    if (tile != nullptr)
+      return tile;
+
+    // Publish a freshly rasterized tile, unless another thread beat us to it.
+    Sample* rasterized = Rasterize(tile_x, tile_y);
+    if (slot.compare_exchange_strong(tile, rasterized,
+                                     std::memory_order_acq_rel))
+      return rasterized;
+
+    delete[] rasterized;
+    return tile;
+  }
+
+} //\ namespace path
@@ -74,15 +74,17 @@ namespace path {
     mean_(0) = x;
     mean_(1) = y;
     location_ = Point2D::Create(x, y);
+    location_value_ = Point2D::Value(x, y);
 
     cov_(0, 0) = sigma_xx;
     cov_(0, 1) = sigma_xy;
     cov_(1, 0) = sigma_xy;
     cov_(1, 1) = sigma_yy;
 
-    // Precalculate determinant and inverse.
+    // Precalculate determinant, inverse, and normalization constant.
     det_ = cov_.determinant();
     inv_ = cov_.inverse();
+    normalization_ = 1.0 / std::sqrt((2.0 * M_PI) * (2.0 * M_PI) * det_);
 
     // Determine radius from zscore. Note that the largest eigenvalue of the
     // covariance matrix is the variance along the principle axis.
@@ -96,56 +98,83 @@ namespace path {
     mean_(0) = x;
     mean_(1) = y;
     location_ = Point2D::Create(x, y);
+    location_value_ = Point2D::Value(x, y);
 
     cov_(0, 0) = radius * radius / 3.0;
     cov_(0, 1) = 0.0;
     cov_(1, 0) = 0.0;
     cov_(1, 1) = radius * radius / 3.0;
 
-    // Precalculate determinant and inverse.
+    // Precalculate determinant, inverse, and normalization constant.
     det_ = cov_.determinant();
     inv_ = cov_.inverse();
+    normalization_ = 1.0 / std::sqrt((2.0 * M_PI) * (2.0 * M_PI) * det_);
 
     // Set radius.
     radius_ = radius;
   }
 
   // Get location.
-  Point2D::Ptr Obstacle2D::GetLocation() {
+  Point2D::Ptr Obstacle2D::GetLocation() const {
     return location_;
   }
 
+  const Point2D::Value& Obstacle2D::GetLocationValue() const {
+    return location_value_;
+  }
+
   // Get radius.
-  float Obstacle2D::GetRadius() {
+  float Obstacle2D::GetRadius() const {
     return radius_;
   }
 
+  // Get inverse covariance and normalization constant of the cost.
+  const Matrix2f& Obstacle2D::GetInverseCovariance() const {
+    return inv_;
+  }
+
+  float Obstacle2D::GetNormalization() const {
+    return normalization_;
+  }
+
   // Is this point feasible?
   bool Obstacle2D::IsFeasible(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return IsFeasible(Point2D::Value(*point));
+  }
 
-    if (Point2D::DistancePointToPoint(point, location_) < radius_)
-      return false;
-    return true;
+  bool Obstacle2D::IsFeasible(const Point2D::Value& point) const {
+    return Point2D::DistancePointToPoint(point, location_value_) >= radius_;
   }
 
   // What is the cost of occupying this point?
   float Obstacle2D::Cost(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return Cost(Point2D::Value(*point));
+  }
 
-    Vector2f query(point->x, point->y);
-    return std::exp(-0.5 * (query - mean_).transpose() * inv_ * (query - mean_)) /
-      std::sqrt((2.0 * M_PI) * (2.0 * M_PI) * det_);
+  float Obstacle2D::Cost(const Point2D::Value& point) const {
+    // Expand the quadratic form by hand; inv_ is symmetric.
+    float dx = point.x - mean_(0);
+    float dy = point.y - mean_(1);
+    float mahalanobis = inv_(0, 0) * dx * dx +
+      2.0 * inv_(0, 1) * dx * dy + inv_(1, 1) * dy * dy;
+    return normalization_ * std::exp(-0.5 * mahalanobis);
   }
 
   // Derivative of the cost function by position. This is used for
   // trajectory optimization.
   Point2D::Ptr Obstacle2D::Derivative(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return Point2D::Create(Derivative(Point2D::Value(*point)));
+  }
 
-    Vector2f point_vector(point->x, point->y);
-    Vector2f vector_derivative = -Cost(point) * inv_ * (point_vector - mean_);
-    return Point2D::Create(vector_derivative(0), vector_derivative(1));
+  Point2D::Value Obstacle2D::Derivative(const Point2D::Value& point) const {
+    float dx = point.x - mean_(0);
+    float dy = point.y - mean_(1);
+    float cost = Cost(point);
+    return Point2D::Value(-cost * (inv_(0, 0) * dx + inv_(0, 1) * dy),
+                          -cost * (inv_(1, 0) * dx + inv_(1, 1) * dy));
   }
 
 } //\ namespace path
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class indexes the obstacles in a scene by location with a KdTree2D,
+// for quick nearest neighbor and radius queries.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <scene/obstacle_2dtree.h>
+#include <glog/logging.h>
+
+namespace path {
+
+  // Add obstacles to the index.
+  void Obstacle2DTree::AddObstacle(Obstacle2D::Ptr obstacle) {
+    CHECK_NOTNULL(obstacle.get());
+
+    kd_tree_.AddPoint(obstacle->GetLocationValue(), obstacle->GetRadius());
+    obstacles_.push_back(obstacle);
+  }
+
+  void Obstacle2DTree::AddObstacles(std::vector<Obstacle2D::Ptr>& obstacles) {
+    for (auto& obstacle : obstacles)
+      AddObstacle(obstacle);
+  }
+
+  // Number of obstacles, and access by index.
+  int Obstacle2DTree::Size() const {
+    return static_cast<int>(obstacles_.size());
+  }
+
+  const Obstacle2D::Ptr& Obstacle2DTree::GetObstacle(int index) const {
+    CHECK(index >= 0 && index < Size());
+    return obstacles_[index];
+  }
+
+  // Queries the kd tree for the nearest neighbor of 'query'.
+  bool Obstacle2DTree::NearestNeighbor(Point2D::Ptr query,
+                                       Obstacle2D::Ptr& nearest,
+                                       float& nn_distance) const {
+    CHECK_NOTNULL(query.get());
+    return NearestNeighbor(Point2D::Value(*query), nearest, nn_distance);
+  }
+
+  bool Obstacle2DTree::NearestNeighbor(const Point2D::Value& query,
+                                       Obstacle2D::Ptr& nearest,
+                                       float& nn_distance) const {
+    int nearest_index = -1;
+    if (!NearestNeighbor(query, nearest_index, nn_distance))
+      return false;
+
+    nearest = obstacles_[nearest_index];
+    return true;
+  }
+
+  bool Obstacle2DTree::NearestNeighbor(const Point2D::Value& query,
+                                       int& nearest_index,
+                                       float& nn_distance) const {
+    return kd_tree_.NearestNeighbor(query, nearest_index, nn_distance);
+  }
+
+  // Queries the kd tree for all neighbors of 'query' within the specified radius.
+  bool Obstacle2DTree::RadiusSearch(Point2D::Ptr query,
+                                    std::vector<Obstacle2D::Ptr>& neighbors,
+                                    float radius) const {
+    CHECK_NOTNULL(query.get());
+    return RadiusSearch(Point2D::Value(*query), neighbors, radius);
+  }
+
+  bool Obstacle2DTree::RadiusSearch(const Point2D::Value& query,
+                                    std::vector<Obstacle2D::Ptr>& neighbors,
+                                    float radius) const {
+    neighbors.clear();
+    kd_tree_.RadiusVisit(query, radius, [this, &neighbors](int index) {
+        neighbors.push_back(obstacles_[index]);
+      });
+
+    return !neighbors.empty();
+  }
+
+  bool Obstacle2DTree::RadiusSearch(const Point2D::Value& query,
+                                    std::vector<int>& neighbors,
+                                    float radius) const {
+    return kd_tree_.RadiusSearch(query, neighbors, radius);
+  }
+
+  // Obstacles with |query - center| <= offset + radius_scale * radius.
+  bool Obstacle2DTree::ExtentSearch(const Point2D::Value& query, float offset,
+                                    float radius_scale,
+                                    std::vector<int>& neighbors) const {
+    neighbors.clear();
+    kd_tree_.ExtentVisit(query, offset, radius_scale, [&neighbors](int index) {
+        neighbors.push_back(index);
+      });
+
+    return !neighbors.empty();
+  }
+
+  // Batched queries returning obstacle indices.
+  void Obstacle2DTree::NearestNeighbors(
+                            const std::vector<Point2D::Value>& queries,
+                            std::vector<int>& nearest_indices,
+                            std::vector<float>& nn_distances,
+                            bool parallel) const {
+    kd_tree_.NearestNeighbors(queries, nearest_indices, nn_distances, parallel);
+  }
+
+  void Obstacle2DTree::RadiusSearch(const std::vector<Point2D::Value>& queries,
+                                    std::vector<int>& offsets,
+                                    std::vector<int>& neighbors,
+                                    float radius, bool parallel) const {
+    kd_tree_.RadiusSearch(queries, offsets, neighbors, radius, parallel);
+  }
+
+}  //\namespace path
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class indexes the obstacles in a bounded scene with a uniform grid.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <scene/obstacle_grid_2d.h>
+#include <glog/logging.h>
+
+#include <cmath>
+#include <limits>
+
+namespace path {
+
+  namespace {
+
+    // Upper bound on the number of cells along either axis.
+    const float kMaxCellsPerSide = 1024.0;
+
+    // Single insertions rebuild the grid once there are more than this many
+    // obstacles and twice as many as at the last rebuild.
+    const size_t kMinRebuild = 32;
+
+    // Obstacles with radius above this percentile are kept out of the grid.
+    const size_t kBucketPercentile = 95;
+
+  } //\ namespace
+
+  ObstacleGrid2D::ObstacleGrid2D()
+    : xmin_(0.0), xmax_(0.0), ymin_(0.0), ymax_(0.0) {
+    Rebuild();
+  }
+
+  ObstacleGrid2D::ObstacleGrid2D(float xmin, float xmax,
+                                 float ymin, float ymax)
+    : xmin_(xmin), xmax_(xmax), ymin_(ymin), ymax_(ymax) {
+    Rebuild();
+  }
+
+  // Set the bounds of the grid. Rebuilds the grid.
+  void ObstacleGrid2D::SetBounds(float xmin, float xmax,
+                                 float ymin, float ymax) {
+    xmin_ = xmin;
+    xmax_ = xmax;
+    ymin_ = ymin;
+    ymax_ = ymax;
+    Rebuild();
+  }
+
+  // Add obstacles to the index.
+  void ObstacleGrid2D::AddObstacle(Obstacle2D::Ptr obstacle) {
+    CHECK_NOTNULL(obstacle.get());
+
+    const int index = static_cast<int>(obstacles_.size());
+    obstacles_.push_back(obstacle);
+    locations_.push_back(obstacle->GetLocationValue());
+    radii_.push_back(obstacle->GetRadius());
+    overflow_next_.push_back(-1);
+
+    // Rebuilding on doubling keeps cells about as full as a fresh build, at
+    // amortized constant cost per insertion.
+    if (obstacles_.size() > kMinRebuild &&
+        obstacles_.size() > 2 * num_rebuilt_) {
+      Rebuild();
+      return;
+    }
+
+    // Bucket the obstacle without disturbing the CSR arrays.
+    if (radii_[index] > bucket_radius_) {
+      large_tree_.AddPoint(locations_[index], radii_[index]);
+      large_indices_.push_back(index);
+    } else {
+      const int cell =
+        Row(locations_[index].y) * num_cols_ + Column(locations_[index].x);
+      overflow_next_[index] = overflow_heads_[cell];
+      overflow_heads_[cell] = index;
+    }
+  }
+
+  void ObstacleGrid2D::AddObstacles(std::vector<Obstacle2D::Ptr>& obstacles) {
+    for (const auto& obstacle : obstacles) {
+      CHECK_NOTNULL(obstacle.get());
+
+      obstacles_.push_back(obstacle);
+      locations_.push_back(obstacle->GetLocationValue());
+      radii_.push_back(obstacle->GetRadius());
+    }
+
+    Rebuild();
+  }
+
+  // Number of obstacles, and access by index.
+  int ObstacleGrid2D::Size() const {
+    return static_cast<int>(obstacles_.size());
+  }
+
+  const Obstacle2D::Ptr& ObstacleGrid2D::GetObstacle(int index) const {
+    CHECK(index >= 0 && index < Size());
+    return obstacles_[index];
+  }
+
+  // Nearest obstacle center. Clamping to the grid never shrinks distances
+  // by more than a cell, so any obstacle in ring k (cells at Chebyshev
+  // distance k from the query's cell) is at least (k - 1) cells away.
+  bool ObstacleGrid2D::NearestNeighbor(const Point2D::Value& query,
+                                       int& nearest_index,
+                                       float& nn_distance) const {
+    if (obstacles_.empty())
+      return false;
+
+    nearest_index = -1;
+    float nn_distance_sq = std::numeric_limits<float>::infinity();
+
+    // Visit cells 'begin' through 'end', which are contiguous in a row.
+    auto visit_cells = [&](int begin, int end) {
+      for (int ii = cell_offsets_[begin]; ii < cell_offsets_[end + 1]; ii++) {
+        const float dx = cell_locations_[ii].x - query.x;
+        const float dy = cell_locations_[ii].y - query.y;
+        const float distance_sq = dx * dx + dy * dy;
+        if (distance_sq < nn_distance_sq) {
+          nn_distance_sq = distance_sq;
+          nearest_index = cell_indices_[ii];
+        }
+      }
+
+      for (int cell = begin; cell <= end; cell++) {
+        for (int index = overflow_heads_[cell]; index >= 0;
+             index = overflow_next_[index]) {
+          const float dx = locations_[index].x - query.x;
+          const float dy = locations_[index].y - query.y;
+          const float distance_sq = dx * dx + dy * dy;
+          if (distance_sq < nn_distance_sq) {
+            nn_distance_sq = distance_sq;
+            nearest_index = index;
+          }
+        }
+      }
+    };
+
+    int large_nearest = -1;
+    float large_distance = 0.0;
+    if (large_tree_.NearestNeighbor(query, large_nearest, large_distance) &&
+        large_distance * large_distance < nn_distance_sq) {
+      nn_distance_sq = large_distance * large_distance;
+      nearest_index = large_indices_[large_nearest];
+    }
+
+    const int column = Column(query.x);
+    const int row = Row(query.y);
+    const int max_ring = std::max(num_cols_, num_rows_);
+    for (int ring = 0; ring <= max_ring; ring++) {
+      const float bound = static_cast<float>(ring - 1) * cell_size_;
+      if (ring > 0 && nn_distance_sq <= bound * bound)
+        break;
+
+      const int row_begin = std::max(row - ring, 0);
+      const int row_end = std::min(row + ring, num_rows_ - 1);
+      const int column_begin = std::max(column - ring, 0);
+      const int column_end = std::min(column + ring, num_cols_ - 1);
+
+      for (int rr = row_begin; rr <= row_end; rr++) {
+        const int base = rr * num_cols_;
+        if (rr == row - ring || rr == row + ring) {
+          // Top and bottom edges of the ring are contiguous.
+          visit_cells(base + column_begin, base + column_end);
+        } else {
+          // Left and right edges.
+          if (column - ring >= 0)
+            visit_cells(base + column - ring, base + column - ring);
+          if (column + ring < num_cols_)
+            visit_cells(base + column + ring, base + column + ring);
+        }
+      }
+    }
+
+    nn_distance = std::sqrt(nn_distance_sq);
+    return nearest_index >= 0;
+  }
+
+  // All obstacles centered within 'radius' of 'query'.
+  bool ObstacleGrid2D::RadiusSearch(const Point2D::Value& query,
+                                    std::vector<int>& neighbors,
+                                    float radius) const {
+    neighbors.clear();
+    auto collect = [&neighbors](int index) { neighbors.push_back(index); };
+    IndexVisit(query, radius, 0.0, collect);
+
+    return !neighbors.empty();
+  }
+
+  // Obstacles with |query - center| <= offset + radius_scale * radius.
+  bool ObstacleGrid2D::ExtentSearch(const Point2D::Value& query, float offset,
+                                    float radius_scale,
+                                    std::vector<int>& neighbors) const {
+    neighbors.clear();
+    auto collect = [&neighbors](int index) { neighbors.push_back(index); };
+    IndexVisit(query, offset, radius_scale, collect);
+
+    return !neighbors.empty();
+  }
+
+  // Rebuild the grid from scratch with a counting sort over cells.
+  void ObstacleGrid2D::Rebuild() {
+    const float width = std::max(xmax_ - xmin_, 0.0f);
+    const float height = std::max(ymax_ - ymin_, 0.0f);
+    const size_t num_obstacles = obstacles_.size();
+
+    // Split obstacles into radius classes at the 95th percentile radius.
+    bucket_radius_ = 0.0;
+    if (num_obstacles > 0) {
+      std::vector<float> radii(radii_);
+      const size_t percentile = (num_obstacles - 1) * kBucketPercentile / 100;
+      std::nth_element(radii.begin(), radii.begin() + percentile, radii.end());
+      bucket_radius_ = radii[percentile];
+    }
+
+    large_tree_.Clear();
+    large_indices_.clear();
+    for (size_t ii = 0; ii < num_obstacles; ii++) {
+      if (radii_[ii] > bucket_radius_) {
+        large_tree_.AddPoint(locations_[ii], radii_[ii]);
+        large_indices_.push_back(static_cast<int>(ii));
+      }
+    }
+
+    // Cells about as wide as the largest bucketed obstacle, but not so small
+    // that most of them are empty, nor so many that the offsets dominate
+    // memory. An empty grid is a single cell.
+    float cell_size = std::max(width, height);
+    if (num_obstacles > 0) {
+      cell_size = std::max(2.0f * bucket_radius_,
+                           std::sqrt(width * height / num_obstacles));
+      cell_size =
+        std::max(cell_size, std::max(width, height) / kMaxCellsPerSide);
+    }
+    if (!(cell_size > 0.0))
+      cell_size = 1.0;
+
+    cell_size_ = cell_size;
+    num_cols_ = std::max(1, static_cast<int>(std::ceil(width / cell_size_)));
+    num_rows_ = std::max(1, static_cast<int>(std::ceil(height / cell_size_)));
+
+    // Bucket each small obstacle. Cell assignment is independent per
+    // obstacle; large ones get cell -1.
+    const long num_entries = static_cast<long>(num_obstacles);
+    std::vector<int> cells(num_entries);
+#pragma omp parallel for schedule(static) if (num_entries > 4096)
+    for (long ii = 0; ii < num_entries; ii++) {
+      cells[ii] = (radii_[ii] > bucket_radius_) ? -1 :
+        Row(locations_[ii].y) * num_cols_ + Column(locations_[ii].x);
+    }
+
+    const int num_cells = num_cols_ * num_rows_;
+    cell_offsets_.assign(num_cells + 1, 0);
+    for (long ii = 0; ii < num_entries; ii++) {
+      if (cells[ii] >= 0)
+        cell_offsets_[cells[ii] + 1]++;
+    }
+    for (int ii = 0; ii < num_cells; ii++)
+      cell_offsets_[ii + 1] += cell_offsets_[ii];
+
+    const int num_bucketed = cell_offsets_[num_cells];
+    cell_indices_.resize(num_bucketed);
+    cell_locations_.resize(num_bucketed);
+    cell_radii_.resize(num_bucketed);
+    std::vector<int> cursor(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    for (long ii = 0; ii < num_entries; ii++) {
+      if (cells[ii] < 0)
+        continue;
+
+      const int slot = cursor[cells[ii]]++;
+      cell_indices_[slot] = static_cast<int>(ii);
+      cell_locations_[slot] = locations_[ii];
+      cell_radii_[slot] = radii_[ii];
+    }
+
+    overflow_heads_.assign(num_cells, -1);
+    overflow_next_.assign(num_obstacles, -1);
+    num_rebuilt_ = num_obstacles;
+  }
+
+}  //\namespace path
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class defines the interface for spatial indices over the obstacles in
+// a scene.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <scene/obstacle_index_2d.h>
+
+#include <limits>
+
+namespace path {
+
+  // Batched nearest neighbor queries.
+  void ObstacleIndex2D::NearestNeighbors(
+                            const std::vector<Point2D::Value>& queries,
+                            std::vector<int>& nearest_indices,
+                            std::vector<float>& nn_distances,
+                            bool parallel) const {
+    const long num_queries = static_cast<long>(queries.size());
+    nearest_indices.resize(num_queries);
+    nn_distances.resize(num_queries);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (long ii = 0; ii < num_queries; ii++) {
+      if (!NearestNeighbor(queries[ii], nearest_indices[ii], nn_distances[ii])) {
+        nearest_indices[ii] = -1;
+        nn_distances[ii] = std::numeric_limits<float>::infinity();
+      }
+    }
+  }
+
+  // Batched radius queries.
+  void ObstacleIndex2D::RadiusSearch(const std::vector<Point2D::Value>& queries,
+                                     std::vector<int>& offsets,
+                                     std::vector<int>& neighbors,
+                                     float radius, bool parallel) const {
+    const long num_queries = static_cast<long>(queries.size());
+    std::vector< std::vector<int> > results(num_queries);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (long ii = 0; ii < num_queries; ii++)
+      RadiusSearch(queries[ii], results[ii], radius);
+
+    // Flatten to CSR.
+    offsets.resize(num_queries + 1);
+    offsets[0] = 0;
+    neighbors.clear();
+    for (long ii = 0; ii < num_queries; ii++) {
+      neighbors.insert(neighbors.end(), results[ii].begin(), results[ii].end());
+      offsets[ii + 1] = static_cast<int>(neighbors.size());
+    }
+  }
+
+}  //\namespace path
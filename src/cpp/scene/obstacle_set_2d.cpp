@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This class packs the cost parameters of a set of Obstacle2Ds into flat
+// arrays, and evaluates cost and derivative over them with SIMD kernels.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <scene/obstacle_set_2d.h>
+
+#include <cmath>
+#include <glog/logging.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace path {
+
+  namespace {
+
+    // Vector width, in floats. Arrays are padded to a multiple of this
+    // regardless of which kernel is compiled in.
+    const size_t kLanes = 8;
+
+#ifdef __AVX2__
+    // exp() for eight floats, using the Cephes range reduction and
+    // polynomial. Accurate to a couple of ulps over the range used here.
+    inline __m256 Exp(__m256 x) {
+      const __m256 kMax = _mm256_set1_ps(88.3762626647949f);
+      const __m256 kMin = _mm256_set1_ps(-88.3762626647949f);
+      const __m256 kLog2e = _mm256_set1_ps(1.44269504088896341f);
+      const __m256 kLn2Hi = _mm256_set1_ps(0.693359375f);
+      const __m256 kLn2Lo = _mm256_set1_ps(-2.12194440e-4f);
+      const __m256 kHalf = _mm256_set1_ps(0.5f);
+      const __m256 kOne = _mm256_set1_ps(1.0f);
+
+      x = _mm256_min_ps(_mm256_max_ps(x, kMin), kMax);
+
+      // x = n ln(2) + r, with |r| <= ln(2) / 2.
+      __m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, kLog2e), kHalf));
+      x = _mm256_sub_ps(x, _mm256_mul_ps(n, kLn2Hi));
+      x = _mm256_sub_ps(x, _mm256_mul_ps(n, kLn2Lo));
+
+      // exp(r) ~ 1 + r + r^2 P(r).
+      __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+      p = _mm256_add_ps(_mm256_mul_ps(p, x), _mm256_set1_ps(1.3981999507e-3f));
+      p = _mm256_add_ps(_mm256_mul_ps(p, x), _mm256_set1_ps(8.3334519073e-3f));
+      p = _mm256_add_ps(_mm256_mul_ps(p, x), _mm256_set1_ps(4.1665795894e-2f));
+      p = _mm256_add_ps(_mm256_mul_ps(p, x), _mm256_set1_ps(1.6666665459e-1f));
+      p = _mm256_add_ps(_mm256_mul_ps(p, x), _mm256_set1_ps(5.0000001201e-1f));
+      p = _mm256_mul_ps(p, _mm256_mul_ps(x, x));
+      p = _mm256_add_ps(_mm256_add_ps(p, x), kOne);
+
+      // Scale by 2^n.
+      __m256i exponent = _mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                          _mm256_set1_epi32(127));
+      exponent = _mm256_slli_epi32(exponent, 23);
+      return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+    }
+
+    inline float HorizontalSum(__m256 v) {
+      __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v),
+                              _mm256_extractf128_ps(v, 1));
+      sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+      return _mm_cvtss_f32(sum);
+    }
+
+    // Accumulate cost and derivative from eight obstacles.
+    inline void Accumulate(__m256 px, __m256 py,
+                           __m256 x, __m256 y, __m256 a, __m256 b, __m256 c,
+                           __m256 weight,
+                           __m256& cost, __m256& dx_sum, __m256& dy_sum) {
+      const __m256 dx = _mm256_sub_ps(px, x);
+      const __m256 dy = _mm256_sub_ps(py, y);
+
+      // Gradient of the quadratic form, inv * d.
+      const __m256 gx = _mm256_add_ps(_mm256_mul_ps(a, dx), _mm256_mul_ps(b, dy));
+      const __m256 gy = _mm256_add_ps(_mm256_mul_ps(b, dx), _mm256_mul_ps(c, dy));
+
+      // d' inv d.
+      const __m256 mahalanobis =
+        _mm256_add_ps(_mm256_mul_ps(dx, gx), _mm256_mul_ps(dy, gy));
+      const __m256 e = _mm256_mul_ps(weight, Exp(_mm256_mul_ps(
+        _mm256_set1_ps(-0.5f), mahalanobis)));
+
+      cost = _mm256_add_ps(cost, e);
+      dx_sum = _mm256_sub_ps(dx_sum, _mm256_mul_ps(e, gx));
+      dy_sum = _mm256_sub_ps(dy_sum, _mm256_mul_ps(e, gy));
+    }
+#elif defined(__SSE2__)
+    // SSE2 width, in floats. kLanes is a multiple of this.
+    const size_t kHalfLanes = 4;
+
+    // exp() for four floats, as above. SSE2 has no floor, so n is rounded
+    // to nearest by the conversion instead, which bounds r just the same.
+    inline __m128 Exp(__m128 x) {
+      const __m128 kMax = _mm_set1_ps(88.3762626647949f);
+      const __m128 kMin = _mm_set1_ps(-88.3762626647949f);
+      const __m128 kLog2e = _mm_set1_ps(1.44269504088896341f);
+      const __m128 kLn2Hi = _mm_set1_ps(0.693359375f);
+      const __m128 kLn2Lo = _mm_set1_ps(-2.12194440e-4f);
+      const __m128 kOne = _mm_set1_ps(1.0f);
+
+      x = _mm_min_ps(_mm_max_ps(x, kMin), kMax);
+
+      // x = n ln(2) + r, with |r| <= ln(2) / 2.
+      const __m128i n_int = _mm_cvtps_epi32(_mm_mul_ps(x, kLog2e));
+      const __m128 n = _mm_cvtepi32_ps(n_int);
+      x = _mm_sub_ps(x, _mm_mul_ps(n, kLn2Hi));
+      x = _mm_sub_ps(x, _mm_mul_ps(n, kLn2Lo));
+
+      // exp(r) ~ 1 + r + r^2 P(r).
+      __m128 p = _mm_set1_ps(1.9875691500e-4f);
+      p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.3981999507e-3f));
+      p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(8.3334519073e-3f));
+      p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(4.1665795894e-2f));
+      p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.6666665459e-1f));
+      p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(5.0000001201e-1f));
+      p = _mm_mul_ps(p, _mm_mul_ps(x, x));
+      p = _mm_add_ps(_mm_add_ps(p, x), kOne);
+
+      // Scale by 2^n.
+      __m128i exponent = _mm_add_epi32(n_int, _mm_set1_epi32(127));
+      exponent = _mm_slli_epi32(exponent, 23);
+      return _mm_mul_ps(p, _mm_castsi128_ps(exponent));
+    }
+
+    inline float HorizontalSum(__m128 v) {
+      __m128 sum = _mm_add_ps(v, _mm_movehl_ps(v, v));
+      sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+      return _mm_cvtss_f32(sum);
+    }
+
+    // Accumulate cost and derivative from four obstacles.
+    inline void Accumulate(__m128 px, __m128 py,
+                           __m128 x, __m128 y, __m128 a, __m128 b, __m128 c,
+                           __m128 weight,
+                           __m128& cost, __m128& dx_sum, __m128& dy_sum) {
+      const __m128 dx = _mm_sub_ps(px, x);
+      const __m128 dy = _mm_sub_ps(py, y);
+
+      // Gradient of the quadratic form, inv * d.
+      const __m128 gx = _mm_add_ps(_mm_mul_ps(a, dx), _mm_mul_ps(b, dy));
+      const __m128 gy = _mm_add_ps(_mm_mul_ps(b, dx), _mm_mul_ps(c, dy));
+
+      // d' inv d.
+      const __m128 mahalanobis =
+        _mm_add_ps(_mm_mul_ps(dx, gx), _mm_mul_ps(dy, gy));
+      const __m128 e = _mm_mul_ps(weight, Exp(_mm_mul_ps(
+        _mm_set1_ps(-0.5f), mahalanobis)));
+
+      cost = _mm_add_ps(cost, e);
+      dx_sum = _mm_sub_ps(dx_sum, _mm_mul_ps(e, gx));
+      dy_sum = _mm_sub_ps(dy_sum, _mm_mul_ps(e, gy));
+    }
+
+    // Load the entries of 'values' at four indices.
+    inline __m128 Gather(const float* values, const int* lanes) {
+      return _mm_setr_ps(values[lanes[0]], values[lanes[1]],
+                         values[lanes[2]], values[lanes[3]]);
+    }
+#endif
+
+  } //\ namespace
+
+  ObstacleSet2D::ObstacleSet2D() : size_(0) {
+    Pad(0);
+  }
+
+  // Add an obstacle.
+  void ObstacleSet2D::AddObstacle(const Obstacle2D& obstacle) {
+    const size_t index = size_++;
+    Pad(size_);
+
+    const Point2D::Value& location = obstacle.GetLocationValue();
+    const Matrix2f& inv = obstacle.GetInverseCovariance();
+    x_[index] = location.x;
+    y_[index] = location.y;
+    a_[index] = inv(0, 0);
+    b_[index] = inv(0, 1);
+    c_[index] = inv(1, 1);
+    weight_[index] = obstacle.GetNormalization();
+  }
+
+  // Number of obstacles.
+  size_t ObstacleSet2D::Size() const {
+    return size_;
+  }
+
+  void ObstacleSet2D::Clear() {
+    size_ = 0;
+    x_.clear();
+    y_.clear();
+    a_.clear();
+    b_.clear();
+    c_.clear();
+    weight_.clear();
+    Pad(0);
+  }
+
+  // Resize the arrays to hold 'size' obstacles plus at least one padding
+  // entry. New entries are zero, so they contribute nothing.
+  void ObstacleSet2D::Pad(size_t size) {
+    const size_t padded = ((size + kLanes) / kLanes) * kLanes;
+    x_.resize(padded, 0.0);
+    y_.resize(padded, 0.0);
+    a_.resize(padded, 0.0);
+    b_.resize(padded, 0.0);
+    c_.resize(padded, 0.0);
+    weight_.resize(padded, 0.0);
+  }
+
+  // Total cost at 'point' from every obstacle.
+  float ObstacleSet2D::Cost(const Point2D::Value& point,
+                            Point2D::Value* derivative) const {
+#ifdef __AVX2__
+    const size_t padded = x_.size();
+    const __m256 px = _mm256_set1_ps(point.x);
+    const __m256 py = _mm256_set1_ps(point.y);
+    __m256 cost = _mm256_setzero_ps();
+    __m256 dx_sum = _mm256_setzero_ps();
+    __m256 dy_sum = _mm256_setzero_ps();
+
+    for (size_t ii = 0; ii < padded; ii += kLanes) {
+      Accumulate(px, py,
+                 _mm256_loadu_ps(&x_[ii]), _mm256_loadu_ps(&y_[ii]),
+                 _mm256_loadu_ps(&a_[ii]), _mm256_loadu_ps(&b_[ii]),
+                 _mm256_loadu_ps(&c_[ii]), _mm256_loadu_ps(&weight_[ii]),
+                 cost, dx_sum, dy_sum);
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(HorizontalSum(dx_sum), HorizontalSum(dy_sum));
+    return HorizontalSum(cost);
+#elif defined(__SSE2__)
+    const size_t padded = x_.size();
+    const __m128 px = _mm_set1_ps(point.x);
+    const __m128 py = _mm_set1_ps(point.y);
+    __m128 cost = _mm_setzero_ps();
+    __m128 dx_sum = _mm_setzero_ps();
+    __m128 dy_sum = _mm_setzero_ps();
+
+    for (size_t ii = 0; ii < padded; ii += kHalfLanes) {
+      Accumulate(px, py,
+                 _mm_loadu_ps(&x_[ii]), _mm_loadu_ps(&y_[ii]),
+                 _mm_loadu_ps(&a_[ii]), _mm_loadu_ps(&b_[ii]),
+                 _mm_loadu_ps(&c_[ii]), _mm_loadu_ps(&weight_[ii]),
+                 cost, dx_sum, dy_sum);
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(HorizontalSum(dx_sum), HorizontalSum(dy_sum));
+    return HorizontalSum(cost);
+#else
+    float cost = 0.0;
+    float dx_sum = 0.0;
+    float dy_sum = 0.0;
+    for (size_t ii = 0; ii < size_; ii++) {
+      const float dx = point.x - x_[ii];
+      const float dy = point.y - y_[ii];
+      const float gx = a_[ii] * dx + b_[ii] * dy;
+      const float gy = b_[ii] * dx + c_[ii] * dy;
+      const float e = weight_[ii] * std::exp(-0.5f * (dx * gx + dy * gy));
+      cost += e;
+      dx_sum -= e * gx;
+      dy_sum -= e * gy;
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(dx_sum, dy_sum);
+    return cost;
+#endif
+  }
+
+  // Total cost at 'point' from the listed obstacles.
+  float ObstacleSet2D::Cost(const Point2D::Value& point, const int* indices,
+                            size_t count, Point2D::Value* derivative) const {
+    CHECK(count == 0 || indices != nullptr);
+
+#ifdef __AVX2__
+    const __m256 px = _mm256_set1_ps(point.x);
+    const __m256 py = _mm256_set1_ps(point.y);
+    __m256 cost = _mm256_setzero_ps();
+    __m256 dx_sum = _mm256_setzero_ps();
+    __m256 dy_sum = _mm256_setzero_ps();
+
+    for (size_t ii = 0; ii < count; ii += kLanes) {
+      // Fill a partial last group with the zero-weight padding entry.
+      __m256i lanes;
+      if (ii + kLanes <= count) {
+        lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + ii));
+      } else {
+        int tail[kLanes];
+        for (size_t jj = 0; jj < kLanes; jj++)
+          tail[jj] = (ii + jj < count) ?
+            indices[ii + jj] : static_cast<int>(size_);
+        lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+      }
+
+      Accumulate(px, py,
+                 _mm256_i32gather_ps(x_.data(), lanes, 4),
+                 _mm256_i32gather_ps(y_.data(), lanes, 4),
+                 _mm256_i32gather_ps(a_.data(), lanes, 4),
+                 _mm256_i32gather_ps(b_.data(), lanes, 4),
+                 _mm256_i32gather_ps(c_.data(), lanes, 4),
+                 _mm256_i32gather_ps(weight_.data(), lanes, 4),
+                 cost, dx_sum, dy_sum);
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(HorizontalSum(dx_sum), HorizontalSum(dy_sum));
+    return HorizontalSum(cost);
+#elif defined(__SSE2__)
+    const __m128 px = _mm_set1_ps(point.x);
+    const __m128 py = _mm_set1_ps(point.y);
+    __m128 cost = _mm_setzero_ps();
+    __m128 dx_sum = _mm_setzero_ps();
+    __m128 dy_sum = _mm_setzero_ps();
+
+    for (size_t ii = 0; ii < count; ii += kHalfLanes) {
+      // Fill a partial last group with the zero-weight padding entry.
+      int lanes[kHalfLanes];
+      for (size_t jj = 0; jj < kHalfLanes; jj++)
+        lanes[jj] = (ii + jj < count) ?
+          indices[ii + jj] : static_cast<int>(size_);
+
+      Accumulate(px, py,
+                 Gather(x_.data(), lanes), Gather(y_.data(), lanes),
+                 Gather(a_.data(), lanes), Gather(b_.data(), lanes),
+                 Gather(c_.data(), lanes), Gather(weight_.data(), lanes),
+                 cost, dx_sum, dy_sum);
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(HorizontalSum(dx_sum), HorizontalSum(dy_sum));
+    return HorizontalSum(cost);
+#else
+    float cost = 0.0;
+    float dx_sum = 0.0;
+    float dy_sum = 0.0;
+    for (size_t ii = 0; ii < count; ii++) {
+      const int jj = indices[ii];
+      const float dx = point.x - x_[jj];
+      const float dy = point.y - y_[jj];
+      const float gx = a_[jj] * dx + b_[jj] * dy;
+      const float gy = b_[jj] * dx + c_[jj] * dy;
+      const float e = weight_[jj] * std::exp(-0.5f * (dx * gx + dy * gy));
+      cost += e;
+      dx_sum -= e * gx;
+      dy_sum -= e * gy;
+    }
+
+    if (derivative != nullptr)
+      *derivative = Point2D::Value(dx_sum, dy_sum);
+    return cost;
+#endif
+  }
+
+  // Total cost at each of many points from every obstacle.
+  void ObstacleSet2D::Cost(const std::vector<Point2D::Value>& points,
+                           std::vector<float>& costs,
+                           std::vector<Point2D::Value>* derivatives) const {
+    const long num_points = static_cast<long>(points.size());
+    costs.resize(num_points);
+    if (derivatives != nullptr)
+      derivatives->resize(num_points);
+
+#pragma omp parallel for schedule(static) if (num_points * size_ > 65536)
+    for (long ii = 0; ii < num_points; ii++) {
+      costs[ii] = Cost(points[ii], (derivatives != nullptr) ?
+                       &(*derivatives)[ii] : nullptr);
+    }
+  }
+
+} //\ namespace path
@@ -41,36 +41,54 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <scene/scene_2d_continuous.h>
+#include <optimization/trajectory_optimizer_2d.h>
 #include <math/random_generator.h>
 #include <geometry/point_2d.h>
 
 #include <glog/logging.h>
 #include <Eigen/Dense>
+#include <cmath>
 #include <memory>
 #include <iostream>
 
 using Eigen::MatrixXf;
-using Eigen::Vector2d;
 
 namespace path {
 
+  namespace {
+
+    // Cost and its derivative only include obstacles within this many of
+    // their own radii of the query point.
+    const float kCostRadiusScale = 10.0;
+
+  } //\ namespace
+
   // Dummy constructor. MUST call SetBounds after this.
-  Scene2DContinuous::Scene2DContinuous()
-    : largest_obstacle_radius_(0.0),
+  Scene2DContinuous::Scene2DContinuous(IndexType index_type)
+    : index_type_(index_type),
+      largest_obstacle_radius_(0.0),
       xmin_(0.0), xmax_(0.0),
       ymin_(0.0), ymax_(0.0) {}
 
   // Better to use these constructors if possible.
   Scene2DContinuous::Scene2DContinuous(float xmin, float xmax,
-                                       float ymin, float ymax)
-    : largest_obstacle_radius_(0.0),
+                                       float ymin, float ymax,
+                                       IndexType index_type)
+    : index_type_(index_type),
+      largest_obstacle_radius_(0.0),
       xmin_(xmin), xmax_(xmax),
-      ymin_(ymin), ymax_(ymax) {}
+      ymin_(ymin), ymax_(ymax) {
+    // The grid is only bounded (and allocated) when it is the index.
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.SetBounds(xmin, xmax, ymin, ymax);
+  }
 
   Scene2DContinuous::Scene2DContinuous(float xmin, float xmax,
                                        float ymin, float ymax,
-                                       std::vector<Obstacle2D::Ptr>& obstacles)
+                                       std::vector<Obstacle2D::Ptr>& obstacles,
+                                       IndexType index_type)
     : obstacles_(obstacles),
+      index_type_(index_type),
       xmin_(xmin), xmax_(xmax),
       ymin_(ymin), ymax_(ymax) {
 
@@ -83,8 +101,16 @@ namespace path {
         largest_obstacle_radius_ = obstacle->GetRadius();
     }
 
-    // Obstacle tree.
-    obstacle_tree_.AddObstacles(obstacles);
+    // Obstacle index and packed cost parameters.
+    if (index_type_ == UNIFORM_GRID) {
+      obstacle_grid_.SetBounds(xmin, xmax, ymin, ymax);
+      obstacle_grid_.AddObstacles(obstacles);
+    } else {
+      obstacle_tree_.AddObstacles(obstacles);
+    }
+
+    for (const auto& obstacle : obstacles)
+      obstacle_set_.AddObstacle(*obstacle);
   }
 
   // Add an obstacle.
@@ -92,7 +118,20 @@ namespace path {
     CHECK_NOTNULL(obstacle.get());
 
     obstacles_.push_back(obstacle);
-    obstacle_tree_.AddObstacle(obstacle);
+    if (obstacle->GetRadius() > largest_obstacle_radius_)
+      largest_obstacle_radius_ = obstacle->GetRadius();
+
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.AddObstacle(obstacle);
+    else
+      obstacle_tree_.AddObstacle(obstacle);
+
+    obstacle_set_.AddObstacle(*obstacle);
+
+    // Only cost within a few radii of the new obstacle changes.
+    if (cost_field_ != nullptr)
+      cost_field_->Invalidate(obstacle->GetLocationValue(),
+                              kCostRadiusScale * obstacle->GetRadius());
   }
 
   // Get obstacles.
@@ -100,10 +139,16 @@ namespace path {
     return obstacles_;
   }
 
-  FlannObstacle2DTree& Scene2DContinuous::GetObstacleTree() {
+  const ObstacleIndex2D& Scene2DContinuous::GetObstacleIndex() const {
+    if (index_type_ == UNIFORM_GRID)
+      return obstacle_grid_;
     return obstacle_tree_;
   }
 
+  Scene2DContinuous::IndexType Scene2DContinuous::GetIndexType() const {
+    return index_type_;
+  }
+
   float Scene2DContinuous::GetLargestObstacleRadius() const {
     return largest_obstacle_radius_;
   }
@@ -119,137 +164,205 @@ namespace path {
     xmax_ = xmax;
     ymin_ = ymin;
     ymax_ = ymax;
+    if (index_type_ == UNIFORM_GRID)
+      obstacle_grid_.SetBounds(xmin, xmax, ymin, ymax);
+
+    // Re-create the cost cache over the new bounds.
+    if (cost_field_ != nullptr) {
+      const float resolution = cost_field_->GetResolution();
+      const int tile_size = cost_field_->GetTileSize();
+      EnableCostCache(resolution, tile_size);
+    }
+  }
+
+  // Is this point within the scene bounds?
+  bool Scene2DContinuous::IsInBounds(const Point2D::Value& point) const {
+    return point.x >= xmin_ && point.x <= xmax_ &&
+      point.y >= ymin_ && point.y <= ymax_;
+  }
+
+  // Cache cost and its derivative over the scene bounds.
+  void Scene2DContinuous::EnableCostCache(float resolution, int tile_size) {
+    cost_field_.reset(new CostField2D(
+      xmin_, xmax_, ymin_, ymax_, resolution, tile_size,
+      [this](const Point2D::Value& point, Point2D::Value* derivative) {
+        return EvaluateCost(point, derivative);
+      }));
+  }
+
+  void Scene2DContinuous::DisableCostCache() {
+    cost_field_.reset();
+  }
+
+  bool Scene2DContinuous::IsCostCacheEnabled() const {
+    return cost_field_ != nullptr;
   }
 
   // Is this point feasible?
   bool Scene2DContinuous::IsFeasible(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return IsFeasible(Point2D::Value(*point));
+  }
 
-    // Get a list of all obstacles in range.
-    std::vector<Obstacle2D::Ptr> obstacles_in_range;
-    if (!obstacle_tree_.RadiusSearch(point, obstacles_in_range,
-                                     largest_obstacle_radius_)) {
-      VLOG(1) << "Radius search failed during feasibility test. "
-              << "Returning false.";
-      return false;
-    }
-
-    // Check each obstacle.
-    for (const auto& obstacle : obstacles_in_range) {
-      if (!obstacle->IsFeasible(point))
-        return false;
-    }
+  bool Scene2DContinuous::IsFeasible(const Point2D::Value& point) const {
+    // Check each obstacle in range.
+    bool feasible = true;
+    VisitObstacles(point, 0.0, 1.0,
+                   [&](const Obstacle2D& obstacle) {
+        feasible = feasible && obstacle.IsFeasible(point);
+      });
 
-    return true;
+    return feasible;
   }
 
   // What is the cost of occupying this point? For speed, only compute
-  // cost from obstacles within a specific radius.
+  // cost from obstacles within a fixed multiple of their own radius.
   float Scene2DContinuous::Cost(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return Cost(Point2D::Value(*point));
+  }
 
-    // Get a list of all obstacles in range.
-    std::vector<Obstacle2D::Ptr> obstacles_in_range;
-    if (!obstacle_tree_.RadiusSearch(point, obstacles_in_range,
-                                     10.0 * largest_obstacle_radius_)) {
-      VLOG(1) << "Radius search failed during cost evaluation. "
-              << "Returning infinite cost.";
-      return std::numeric_limits<float>::infinity();
-    }
-
-    // Iterate over all obstacles in range.
-    float total_cost = 0.0;
-    for (const auto& obstacle : obstacles_in_range)
-      total_cost += obstacle->Cost(point);
+  float Scene2DContinuous::Cost(const Point2D::Value& point) const {
+    if (cost_field_ != nullptr)
+      return cost_field_->Cost(point);
+    return EvaluateCost(point, nullptr);
+  }
 
-    return total_cost;
+  float Scene2DContinuous::Cost(const Point2D::Value& point,
+                                Point2D::Value* derivative) const {
+    if (cost_field_ != nullptr)
+      return cost_field_->Cost(point, derivative);
+    return EvaluateCost(point, derivative);
   }
 
   // Compute the derivative of cost by position. This is used for
   // trajectory optimization.
   Point2D::Ptr Scene2DContinuous::CostDerivative(Point2D::Ptr point) const {
     CHECK_NOTNULL(point.get());
+    return Point2D::Create(CostDerivative(Point2D::Value(*point)));
+  }
 
-    // Get a list of all obstacles in range.
-    std::vector<Obstacle2D::Ptr> obstacles_in_range;
-    if (!obstacle_tree_.RadiusSearch(point, obstacles_in_range,
-                                     10.0 * largest_obstacle_radius_)) {
-      VLOG(1) << "Radius search failed during derivative evaluation. "
-              << "Returning zero derivative.";
-      return Point2D::Create(0.0, 0.0);
-    }
+  Point2D::Value Scene2DContinuous::CostDerivative(
+                                      const Point2D::Value& point) const {
+    Point2D::Value derivative;
+    if (cost_field_ != nullptr)
+      cost_field_->Cost(point, &derivative);
+    else
+      EvaluateCost(point, &derivative);
+    return derivative;
+  }
 
-    // Iterate over all obstacles in range.
-    Vector2d total_derivative = Vector2d::Zero();
-    for (const auto& obstacle : obstacles_in_range) {
-      Point2D::Ptr derivative = obstacle->Derivative(point);
-      total_derivative(0) += derivative->x;
-      total_derivative(1) += derivative->y;
-    }
+  // Cost, and optionally its derivative, from nearby obstacles. Indices of
+  // obstacles in range are collected in small batches, and each batch is
+  // evaluated with the packed SIMD kernel.
+  float Scene2DContinuous::EvaluateCost(const Point2D::Value& point,
+                                        Point2D::Value* derivative) const {
+    const size_t kBatchSize = 64;
+    int batch[kBatchSize];
+    size_t batch_count = 0;
 
-    return Point2D::Create(total_derivative(0), total_derivative(1));
+    float total_cost = 0.0;
+    Point2D::Value total_derivative(0.0, 0.0);
+    Point2D::Value batch_derivative;
+
+    auto flush = [&]() {
+      total_cost += obstacle_set_.Cost(point, batch, batch_count,
+        (derivative != nullptr) ? &batch_derivative : nullptr);
+      if (derivative != nullptr) {
+        total_derivative.x += batch_derivative.x;
+        total_derivative.y += batch_derivative.y;
+      }
+      batch_count = 0;
+    };
+
+    VisitObstacleIndices(point, 0.0, kCostRadiusScale, [&](int index) {
+        batch[batch_count++] = index;
+        if (batch_count == kBatchSize)
+          flush();
+      });
+
+    if (batch_count > 0)
+      flush();
+
+    if (derivative != nullptr)
+      *derivative = total_derivative;
+    return total_cost;
   }
 
   // Get a random point in the scene.
   Point2D::Ptr Scene2DContinuous::GetRandomPoint() const {
+    return Point2D::Create(GetRandomPointValue());
+  }
+
+  Point2D::Value Scene2DContinuous::GetRandomPointValue() const {
+    std::lock_guard<std::mutex> lock(rng_mutex_);
     float x = static_cast<float>(rng_.DoubleUniform(xmin_, xmax_));
     float y = static_cast<float>(rng_.DoubleUniform(ymin_, ymax_));
-    return Point2D::Create(x, y);
+    return Point2D::Value(x, y);
+  }
+
+  // Get random point 'index' of sample stream 'stream'.
+  Point2D::Ptr Scene2DContinuous::GetRandomPoint(uint64_t stream,
+                                                 uint64_t index) const {
+    return Point2D::Create(GetRandomPointValue(stream, index));
+  }
+
+  Point2D::Value Scene2DContinuous::GetRandomPointValue(uint64_t stream,
+                                                        uint64_t index) const {
+    double u, v;
+    sampler_.DoublePair(stream, index, &u, &v);
+    return Point2D::Value(static_cast<float>(xmin_ + (xmax_ - xmin_) * u),
+                          static_cast<float>(ymin_ + (ymax_ - ymin_) * v));
+  }
+
+  // Seed for indexed random points.
+  void Scene2DContinuous::SetSampleSeed(uint64_t seed) {
+    sampler_.SetSeed(seed);
+  }
+
+  uint64_t Scene2DContinuous::GetSampleSeed() const {
+    return sampler_.GetSeed();
   }
 
   // Optimize the given trajectory to minimize cost.
   Trajectory2D::Ptr Scene2DContinuous::OptimizeTrajectory(
-                                                 Trajectory2D::Ptr path,
-                                                 float gradient_weight,
-                                                 float curvature_penalty,
-                                                 float max_point_displacement,
-                                                 float min_avg_displacement,
-                                                 size_t max_iters) const {
+                                          Trajectory2D::Ptr path,
+                                          float gradient_weight,
+                                          float curvature_penalty,
+                                          float max_point_displacement,
+                                          float min_avg_displacement,
+                                          size_t max_iters,
+                                          bool parallel) const {
     CHECK_NOTNULL(path.get());
 
-    // Extract points from the given trajectory.
-    std::vector<Point2D::Ptr> points(path->GetPoints());
-    float num_points = static_cast<float>(points.size());
-
-    // Create a new trajectory from these soon-to-be-optimized points.
-    Trajectory2D::Ptr optimized = Trajectory2D::Create(points);
-
-    // While the average displacement of all points is large and the total
-    // number of iterations does not exceed the threshold, iterate over
-    // all points and move each point a small distance in the direction
-    // of the negative gradient.
-    float total_displacement = std::numeric_limits<float>::infinity();
-    size_t num_iters = 0;
-    while (total_displacement / num_points > min_avg_displacement &&
-           num_iters < max_iters) {
-      total_displacement = 0.0;
-
-      // Compute second time derivative of the trajectory.
-      Trajectory2D::Ptr time_derivative1 = optimized->TimeDerivative();
-      Trajectory2D::Ptr time_derivative2 = time_derivative1->TimeDerivative();
-
-      for (size_t ii = 1; ii < points.size() - 1; ii++) {
-        Point2D::Ptr point = optimized->GetAt(ii);
-        Point2D::Ptr cost_derivative = CostDerivative(point);
-        Point2D::Ptr time_derivative = time_derivative2->GetAt(ii);
-
-        Point2D::Ptr derivative = Point2D::Add(cost_derivative, time_derivative,
-                                               -curvature_penalty);
-        float step_x = point->x - gradient_weight * derivative->x;
-        float step_y = point->y - gradient_weight * derivative->y;
-        Point2D::Ptr initial_step = Point2D::Create(step_x, step_y);
-        Point2D::Ptr truncated_step = Point2D::StepToward(point, initial_step,
-                                                          max_point_displacement);
-        total_displacement += Point2D::DistancePointToPoint(point,
-                                                            truncated_step);
-
-        optimized->SetAt(truncated_step, ii);
-      }
-
-      num_iters++;
+    if (max_point_displacement != 1e-2f) {
+      LOG_FIRST_N(WARNING, 1) << "OptimizeTrajectory ignores "
+                              << "max_point_displacement, since the trust "
+                              << "region bounds each step.";
     }
 
-    return optimized;
+    // Stepping along -(cost gradient - curvature_penalty * second difference)
+    // descends cost plus half the penalty times squared waypoint spacing, so
+    // that is the objective handed to the least-squares solver.
+    TrajectoryOptimizer2D optimizer(*this, gradient_weight,
+                                    gradient_weight * curvature_penalty);
+
+    // The solver stops once |step| <= (|x| + tol) * tol. Choose 'tol' so that
+    // this bound is the step of every waypoint moving 'min_avg_displacement',
+    // with |x| taken from the initial path.
+    double norm_squared = 0.0;
+    for (size_t ii = 0; ii < path->Size(); ii++) {
+      norm_squared += path->GetX()[ii] * path->GetX()[ii] +
+        path->GetY()[ii] * path->GetY()[ii];
+    }
+    const double norm = std::sqrt(norm_squared);
+    const double max_step = min_avg_displacement *
+      std::sqrt(static_cast<double>(path->Size()));
+    const double tolerance =
+      0.5 * (std::sqrt(norm * norm + 4.0 * max_step) - norm);
+
+    return optimizer.Optimize(path, max_iters,
+                              static_cast<float>(tolerance), parallel);
   }
 
   // Visualize this scene. Optionally pass in the number of pixels
@@ -276,9 +389,7 @@ namespace path {
           static_cast<float>(jj) / static_cast<float>(xsize);
         float y = ymin_ + (ymax_ - ymin_) *
           static_cast<float>(ysize - ii) / static_cast<float>(ysize);
-        Point2D::Ptr point = Point2D::Create(x, y);
-
-        map_matrix(ii, jj) = Cost(point);
+        map_matrix(ii, jj) = Cost(Point2D::Value(x, y));
       }
     }
 
@@ -292,9 +403,7 @@ namespace path {
           static_cast<float>(jj) / static_cast<float>(xsize);
         float y = ymin_ + (ymax_ - ymin_) *
           static_cast<float>(ysize - ii) / static_cast<float>(ysize);
-        Point2D::Ptr point = Point2D::Create(x, y);
-
-        if (!IsFeasible(point))
+        if (!IsFeasible(Point2D::Value(x, y)))
           map_matrix(ii, jj) = 1.0;
       }
     }
@@ -310,36 +419,33 @@ namespace path {
       map_image.ConvertToRGB();
 
       // Draw each point, and put line segments between them.
-      Point2D::Ptr last_point;
-      size_t cnt = 0;
-      for (const auto& next_point : path->GetPoints()) {
+      for (size_t cnt = 0; cnt < path->Size(); cnt++) {
+        Point2D::Value next_point = path->GetValueAt(cnt);
         float u1, v1;
-        u1 = static_cast<float>(ysize) * (1.0 - (next_point->y - ymin_) / (ymax_ - ymin_));
-        v1 = static_cast<float>(xsize) * (next_point->x - xmin_) / (xmax_ - xmin_);
+        u1 = static_cast<float>(ysize) * (1.0 - (next_point.y - ymin_) / (ymax_ - ymin_));
+        v1 = static_cast<float>(xsize) * (next_point.x - xmin_) / (xmax_ - xmin_);
 
         float heat = static_cast<float>(cnt) /
-          static_cast<float>(path->GetPoints().size() - 1);
+          static_cast<float>(path->Size() - 1);
         map_image.Circle(static_cast<unsigned int>(v1),
                          static_cast<unsigned int>(u1),
                          4,  // radius
                          2,  // line thickness
                          heat);
 
-        if (last_point) {
+        if (cnt > 0) {
+          Point2D::Value last_point = path->GetValueAt(cnt - 1);
           unsigned int u2, v2;
           u2 = static_cast<float>(ysize) *
-            (1.0 - (last_point->y - ymin_) / (ymax_ - ymin_));
+            (1.0 - (last_point.y - ymin_) / (ymax_ - ymin_));
           v2 = static_cast<float>(xsize) *
-            (last_point->x - xmin_) / (xmax_ - xmin_);
+            (last_point.x - xmin_) / (xmax_ - xmin_);
 
           map_image.Line(static_cast<unsigned int>(v2), static_cast<unsigned int>(u2),
                          static_cast<unsigned int>(v1), static_cast<unsigned int>(u1),
                          2, // line thickness
                          heat);
         }
-
-        last_point = next_point;
-        cnt++;
       }
     }
 
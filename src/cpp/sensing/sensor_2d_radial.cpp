@@ -91,9 +91,10 @@ namespace path {
           continue;
         }
 
-        // Check line of sight.
+        // Check line of sight. The bin containing the sensor is always visible.
         Point2D::Ptr close = Point2D::StepToward(bin, location, step);
-        if (robot.LineOfSight(location, close)) {
+        if (Point2D::DistancePointToPoint(location, bin) <= 0.0 ||
+            robot.LineOfSight(location, close)) {
           obstacle_count += occupancy;
         }
       }
@@ -140,9 +141,10 @@ namespace path {
           continue;
         }
 
-        // Check line of sight.
+        // Check line of sight. The bin containing the sensor is always visible.
         Point2D::Ptr close = Point2D::StepToward(bin, location, step);
-        if (robot.LineOfSight(location, close)) {
+        if (Point2D::DistancePointToPoint(location, bin) <= 0.0 ||
+            robot.LineOfSight(location, close)) {
           int jj = static_cast<int>((x - grid_.GetXMin()) / step);
           int ii = static_cast<int>((y - grid_.GetYMin()) / step);
           ii = grid_.GetNRows() - ii - 1;
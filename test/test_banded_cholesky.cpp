@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ *          David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+#include <math/banded_cholesky.h>
+#include <math/random_generator.h>
+
+#include <vector>
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+namespace path {
+namespace math {
+
+TEST(BandedCholesky, TestMatchesDenseSolve) {
+  RandomGenerator rng(0);
+
+  const size_t kSize = 40;
+  for (size_t bandwidth = 0; bandwidth < 4; bandwidth++) {
+    // A random diagonally dominant band matrix is positive definite.
+    BandedCholesky banded(kSize, bandwidth);
+    Eigen::MatrixXd dense = Eigen::MatrixXd::Zero(kSize, kSize);
+    for (size_t ii = 0; ii < kSize; ii++) {
+      for (size_t jj = (ii > bandwidth) ? ii - bandwidth : 0; jj < ii; jj++) {
+        const double value = rng.DoubleUniform(-1.0, 1.0);
+        banded.Set(ii, jj, value);
+        dense(ii, jj) = dense(jj, ii) = value;
+      }
+    }
+    for (size_t ii = 0; ii < kSize; ii++) {
+      const double value = 2.0 * bandwidth + 1.0;
+      banded.Set(ii, ii, value);
+      dense(ii, ii) = value;
+    }
+    ASSERT_TRUE(banded.Factorize());
+
+    Eigen::VectorXd b(kSize);
+    std::vector<double> x(kSize);
+    for (size_t ii = 0; ii < kSize; ii++)
+      x[ii] = b(ii) = rng.DoubleUniform(-1.0, 1.0);
+
+    banded.Solve(x.data());
+    const Eigen::VectorXd expected = dense.ldlt().solve(b);
+    for (size_t ii = 0; ii < kSize; ii++)
+      EXPECT_NEAR(expected(ii), x[ii], 1e-9);
+  }
+
+  // Indefinite matrices are rejected.
+  BandedCholesky indefinite(2, 1);
+  indefinite.Set(0, 0, 1.0);
+  indefinite.Set(1, 0, 2.0);
+  indefinite.Set(1, 1, 1.0);
+  EXPECT_FALSE(indefinite.Factorize());
+}
+
+}  //\namespace math
+}  //\namespace path
@@ -40,6 +40,7 @@
 #include <math/random_generator.h>
 #include <util/types.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <gflags/gflags.h>
@@ -102,6 +103,51 @@ namespace path {
                                               nearest),
                 0, 1e-8);
     EXPECT_NEAR(min_distance, nn_distance, 1e-8);
+
+    // Batched queries agree with single queries.
+    std::vector<Point2D::Value> queries;
+    for (int ii = 0; ii < 10; ++ii) {
+      queries.push_back(Point2D::Value(static_cast<float>(rng.Double()),
+                                       static_cast<float>(rng.Double())));
+    }
+
+    std::vector<int> nearest_indices;
+    std::vector<float> nn_distances;
+    EXPECT_TRUE(point_2dtree.NearestNeighbors(queries, nearest_indices,
+                                              nn_distances, true));
+    ASSERT_EQ(queries.size(), nearest_indices.size());
+    ASSERT_EQ(queries.size(), nn_distances.size());
+
+    std::vector<int> offsets, neighbors;
+    EXPECT_TRUE(point_2dtree.RadiusSearch(queries, offsets, neighbors, 0.2));
+    ASSERT_EQ(queries.size() + 1, offsets.size());
+    EXPECT_EQ(0, offsets.front());
+    EXPECT_EQ(static_cast<int>(neighbors.size()), offsets.back());
+
+    for (size_t ii = 0; ii < queries.size(); ++ii) {
+      Point2D::Ptr single_nearest;
+      float single_distance = -1.0;
+      EXPECT_TRUE(point_2dtree.NearestNeighbor(queries[ii], single_nearest,
+                                               single_distance));
+      EXPECT_EQ(single_nearest, points[nearest_indices[ii]]);
+      EXPECT_NEAR(single_distance, nn_distances[ii], 1e-8);
+
+      // Compare neighbor sets by index into 'points', which is insertion
+      // order.
+      std::vector<Point2D::Ptr> single_neighbors;
+      EXPECT_TRUE(point_2dtree.RadiusSearch(queries[ii], single_neighbors,
+                                            0.2));
+      std::vector<int> expected;
+      for (const auto& neighbor : single_neighbors) {
+        expected.push_back(static_cast<int>(
+          std::find(points.begin(), points.end(), neighbor) - points.begin()));
+      }
+      std::vector<int> batched(neighbors.begin() + offsets[ii],
+                               neighbors.begin() + offsets[ii + 1]);
+      std::sort(expected.begin(), expected.end());
+      std::sort(batched.begin(), batched.end());
+      EXPECT_EQ(expected, batched);
+    }
   }
 
 }  //\namespace path
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ *          Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ */
+
+#include <geometry/kdtree_2d.h>
+#include <geometry/point_2d.h>
+#include <math/random_generator.h>
+#include <util/types.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+namespace path {
+
+  TEST(KdTree2D, TestKdTree2D) {
+    math::RandomGenerator rng(0);
+    KdTree2D kd_tree;
+
+    // Empty tree has no neighbors.
+    int nearest = -1;
+    float nn_distance = -1.0;
+    std::vector<int> neighbors;
+    EXPECT_FALSE(kd_tree.NearestNeighbor(Point2D::Value(0.5, 0.5),
+                                         nearest, nn_distance));
+    EXPECT_FALSE(kd_tree.RadiusSearch(Point2D::Value(0.5, 0.5),
+                                      neighbors, 1.0));
+
+    // Insert points one at a time, checking against brute force at sizes
+    // on either side of every merge.
+    std::vector<Point2D::Value> points;
+    for (int ii = 0; ii < 1000; ++ii) {
+      Point2D::Value point(static_cast<float>(rng.Double()),
+                           static_cast<float>(rng.Double()));
+      points.push_back(point);
+      EXPECT_EQ(kd_tree.AddPoint(point), ii);
+      EXPECT_EQ(kd_tree.Size(), points.size());
+
+      if (ii % 7 != 0)
+        continue;
+
+      Point2D::Value query(static_cast<float>(rng.Double()),
+                           static_cast<float>(rng.Double()));
+      const float radius = 0.1;
+
+      float min_distance = std::numeric_limits<float>::max();
+      std::vector<int> expected;
+      for (size_t jj = 0; jj < points.size(); ++jj) {
+        float distance = Point2D::DistancePointToPoint(points[jj], query);
+        min_distance = std::min(min_distance, distance);
+        if (distance <= radius)
+          expected.push_back(static_cast<int>(jj));
+      }
+
+      EXPECT_TRUE(kd_tree.NearestNeighbor(query, nearest, nn_distance));
+      EXPECT_NEAR(min_distance, nn_distance, 1e-6);
+      EXPECT_NEAR(Point2D::DistancePointToPoint(kd_tree.GetPoint(nearest),
+                                                query),
+                  min_distance, 1e-6);
+
+      kd_tree.RadiusSearch(query, neighbors, radius);
+      std::sort(neighbors.begin(), neighbors.end());
+      EXPECT_EQ(expected, neighbors);
+    }
+
+    kd_tree.Clear();
+    EXPECT_EQ(kd_tree.Size(), 0);
+  }
+
+  TEST(KdTree2D, TestBatchQueries) {
+    math::RandomGenerator rng(0);
+    KdTree2D kd_tree;
+
+    for (int ii = 0; ii < 500; ++ii)
+      kd_tree.AddPoint(Point2D::Value(static_cast<float>(rng.Double()),
+                                      static_cast<float>(rng.Double())));
+
+    std::vector<Point2D::Value> queries;
+    for (int ii = 0; ii < 200; ++ii)
+      queries.push_back(Point2D::Value(static_cast<float>(rng.Double()),
+                                       static_cast<float>(rng.Double())));
+
+    // Batched results must match one-at-a-time queries, serial or parallel.
+    for (bool parallel : { false, true }) {
+      std::vector<int> nearest_indices;
+      std::vector<float> nn_distances;
+      kd_tree.NearestNeighbors(queries, nearest_indices, nn_distances,
+                               parallel);
+      ASSERT_EQ(nearest_indices.size(), queries.size());
+
+      std::vector<int> offsets, neighbors;
+      kd_tree.RadiusSearch(queries, offsets, neighbors, 0.1, parallel);
+      ASSERT_EQ(offsets.size(), queries.size() + 1);
+      EXPECT_EQ(offsets.back(), neighbors.size());
+
+      for (size_t ii = 0; ii < queries.size(); ++ii) {
+        int nearest = -1;
+        float nn_distance = -1.0;
+        kd_tree.NearestNeighbor(queries[ii], nearest, nn_distance);
+        EXPECT_EQ(nearest, nearest_indices[ii]);
+        EXPECT_EQ(nn_distance, nn_distances[ii]);
+
+        std::vector<int> expected;
+        kd_tree.RadiusSearch(queries[ii], expected, 0.1);
+        std::vector<int> batched(neighbors.begin() + offsets[ii],
+                                 neighbors.begin() + offsets[ii + 1]);
+        EXPECT_EQ(expected, batched);
+      }
+    }
+  }
+
+  TEST(KdTree2D, TestExtentVisit) {
+    math::RandomGenerator rng(0);
+    KdTree2D kd_tree;
+
+    // Mostly small extents with a few large ones.
+    std::vector<Point2D::Value> points;
+    std::vector<float> extents;
+    for (int ii = 0; ii < 700; ++ii) {
+      points.push_back(Point2D::Value(static_cast<float>(rng.Double()),
+                                      static_cast<float>(rng.Double())));
+      extents.push_back((ii % 50 == 0) ? 0.3 : 0.01 * rng.Double());
+      kd_tree.AddPoint(points.back(), extents.back());
+      EXPECT_EQ(kd_tree.GetExtent(ii), extents.back());
+    }
+
+    for (int ii = 0; ii < 100; ++ii) {
+      Point2D::Value query(static_cast<float>(rng.Double()),
+                           static_cast<float>(rng.Double()));
+      const float offset = 0.02;
+      const float extent_scale = 2.0;
+
+      std::vector<int> expected;
+      for (size_t jj = 0; jj < points.size(); ++jj) {
+        float distance = Point2D::DistancePointToPoint(points[jj], query);
+        if (distance <= offset + extent_scale * extents[jj])
+          expected.push_back(static_cast<int>(jj));
+      }
+
+      std::vector<int> found;
+      kd_tree.ExtentVisit(query, offset, extent_scale,
+                          [&found](int index) { found.push_back(index); });
+      std::sort(found.begin(), found.end());
+      EXPECT_EQ(expected, found);
+    }
+  }
+
+  TEST(KdTree2D, TestRemove) {
+    math::RandomGenerator rng(0);
+    KdTree2D kd_tree;
+
+    // Remove every third point, both in trees and in the buffer.
+    std::vector<Point2D::Value> points;
+    for (int ii = 0; ii < 500; ++ii) {
+      points.push_back(Point2D::Value(static_cast<float>(rng.Double()),
+                                      static_cast<float>(rng.Double())));
+      kd_tree.AddPoint(points.back());
+    }
+    for (int ii = 0; ii < 500; ii += 3)
+      kd_tree.Remove(ii);
+
+    for (int ii = 0; ii < 100; ++ii) {
+      Point2D::Value query(static_cast<float>(rng.Double()),
+                           static_cast<float>(rng.Double()));
+
+      int expected_nearest = -1;
+      float min_distance = std::numeric_limits<float>::infinity();
+      std::vector<int> expected;
+      for (size_t jj = 0; jj < points.size(); ++jj) {
+        if (jj % 3 == 0)
+          continue;
+
+        float distance = Point2D::DistancePointToPoint(points[jj], query);
+        if (distance < min_distance) {
+          min_distance = distance;
+          expected_nearest = static_cast<int>(jj);
+        }
+        if (distance <= 0.1)
+          expected.push_back(static_cast<int>(jj));
+      }
+
+      int nearest = -1;
+      float nn_distance;
+      ASSERT_TRUE(kd_tree.NearestNeighbor(query, nearest, nn_distance));
+      EXPECT_EQ(expected_nearest, nearest);
+
+      std::vector<int> found;
+      kd_tree.RadiusSearch(query, found, 0.1);
+      std::sort(found.begin(), found.end());
+      EXPECT_EQ(expected, found);
+    }
+
+    // Restored points are found again.
+    kd_tree.Restore(0);
+    int nearest = -1;
+    float nn_distance;
+    ASSERT_TRUE(kd_tree.NearestNeighbor(points[0], nearest, nn_distance));
+    EXPECT_EQ(0, nearest);
+  }
+
+}  //\namespace path
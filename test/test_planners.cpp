@@ -36,16 +36,33 @@
 
 #include <geometry/trajectory_2d.h>
 #include <geometry/point_2d.h>
+#include <planning/grid_astar_planner_2d.h>
 #include <planning/rrt_planner_2d.h>
+#include <planning/rrt_connect_planner_2d.h>
+#include <planning/parallel_rrt_planner_2d.h>
+#include <planning/prm_planner_2d.h>
+#include <planning/incremental_rrt_planner_2d.h>
+#include <planning/rrt_star_planner_2d.h>
+#include <planning/informed_sampler_2d.h>
+#include <planning/uniform_sampler_2d.h>
+#include <occupancy/occupancy_grid_2d.h>
 #include <robot/robot_2d_circular.h>
 #include <math/random_generator.h>
 #include <scene/scene_2d_continuous.h>
 #include <scene/obstacle_2d.h>
 #include <image/image.h>
+#include <util/cancellation_token.h>
+#include <util/deadline.h>
+#include <util/status.h>
+#include <util/timer.h>
 #include <util/types.h>
 
 #include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <cmath>
+#include <limits>
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
@@ -171,4 +188,487 @@ namespace path {
     }
   }
 
+  // Test that lazy collision checking still returns a collision-free path.
+  TEST(RRTPlanner2D, TestLazyCollisionChecking) {
+    math::RandomGenerator rng(0);
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 100; ii++) {
+      float x = rng.DoubleUniform(0.1, 0.9);
+      float y = rng.DoubleUniform(0.1, 0.9);
+      float radius = static_cast<float>(rng.DoubleUniform(0.01, 0.03));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+    Point2D::Ptr origin = Point2D::Create(0.05, 0.05);
+    Point2D::Ptr goal = Point2D::Create(0.95, 0.95);
+
+    RRTPlanner2D planner(robot, scene, origin, goal, 0.05);
+    planner.SetLazyCollisionChecking(true);
+    Trajectory2D::Ptr route;
+    ASSERT_TRUE(planner.PlanTrajectory(util::Deadline::Never(), nullptr,
+                                       route).ok());
+
+    ASSERT_GE(route->Size(), 2u);
+    EXPECT_EQ(goal->x, route->GetX()[route->Size() - 1]);
+    EXPECT_EQ(goal->y, route->GetY()[route->Size() - 1]);
+    for (size_t ii = 0; ii + 1 < route->Size(); ii++) {
+      EXPECT_TRUE(robot.LineOfSight(route->GetValueAt(ii),
+                                    route->GetValueAt(ii + 1)));
+    }
+  }
+
+  // Test that RRT-Connect joins its two trees into a feasible path.
+  TEST(RRTConnectPlanner2D, TestRRTConnectPlanner2D) {
+    math::RandomGenerator rng(0);
+
+    // Create a bunch of obstacles.
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 200; ii++) {
+      float x = rng.Double();
+      float y = rng.Double();
+      float radius = static_cast<float>(rng.DoubleUniform(0.01, 0.02));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+
+    // Choose feasible origin/goal in opposite corners.
+    Point2D::Ptr origin, goal;
+    while (!origin) {
+      Point2D::Ptr point = Point2D::Create(0.2 * rng.Double(),
+                                           0.2 * rng.Double());
+      if (robot.IsFeasible(point))
+        origin = point;
+    }
+    while (!goal) {
+      Point2D::Ptr point = Point2D::Create(1.0 - 0.2 * rng.Double(),
+                                           1.0 - 0.2 * rng.Double());
+      if (robot.IsFeasible(point))
+        goal = point;
+    }
+
+    RRTConnectPlanner2D planner(robot, scene, origin, goal, 0.05);
+    Trajectory2D::Ptr route = planner.PlanTrajectory();
+
+    ASSERT_GE(route->Size(), 2u);
+    EXPECT_EQ(origin->x, route->GetX()[0]);
+    EXPECT_EQ(origin->y, route->GetY()[0]);
+    EXPECT_EQ(goal->x, route->GetX()[route->Size() - 1]);
+    EXPECT_EQ(goal->y, route->GetY()[route->Size() - 1]);
+    for (size_t ii = 0; ii + 1 < route->Size(); ii++) {
+      EXPECT_TRUE(robot.LineOfSight(
+        Point2D::Value(route->GetX()[ii], route->GetY()[ii]),
+        Point2D::Value(route->GetX()[ii + 1], route->GetY()[ii + 1])));
+    }
+
+    if (FLAGS_visualize_planner) {
+      scene.Visualize("RRT-Connect route", route);
+    }
+  }
+
+  // Test that RRT* approaches the straight line in free space, and that
+  // more samples never make the path longer.
+  TEST(RRTStarPlanner2D, TestRRTStarPlanner2D) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+
+    Point2D::Ptr origin = Point2D::Create(0.1, 0.1);
+    Point2D::Ptr goal = Point2D::Create(0.9, 0.9);
+    const float kShortest = Point2D::DistancePointToPoint(origin, goal);
+
+    RRTStarPlanner2D planner(robot, scene, origin, goal, 0.05, 2000);
+    Trajectory2D::Ptr route = planner.PlanTrajectory();
+    const float first_cost = planner.GetBestCost();
+
+    ASSERT_GE(route->Size(), 2u);
+    EXPECT_NEAR(first_cost, route->GetLength(), 1e-4);
+    EXPECT_EQ(goal->x, route->GetX()[route->Size() - 1]);
+    EXPECT_EQ(goal->y, route->GetY()[route->Size() - 1]);
+
+    route = planner.PlanTrajectory();
+    EXPECT_LE(planner.GetBestCost(), first_cost);
+    EXPECT_NEAR(planner.GetBestCost(), route->GetLength(), 1e-4);
+    EXPECT_LT(planner.GetBestCost(), 1.05 * kShortest);
+  }
+
+  // Test that informed samples stay in the ellipse of points that could
+  // shorten the path, even when most of it lies outside the scene, and
+  // that they fall back to uniform samples.
+  TEST(InformedSampler2D, TestInformedSampler2D) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const Point2D::Value origin(0.1, 0.2);
+    const Point2D::Value goal(0.8, 0.6);
+    InformedSampler2D::Ptr informed =
+      InformedSampler2D::Create(scene, origin, goal);
+    UniformSampler2D::Ptr uniform = UniformSampler2D::Create(scene);
+
+    const float kInfinity = std::numeric_limits<float>::infinity();
+    const float kBestCost =
+      1.2 * Point2D::DistancePointToPoint(origin, goal);
+    const float kLooseCost =
+      2.5 * Point2D::DistancePointToPoint(origin, goal);
+    for (uint64_t ii = 0; ii < 1000; ii++) {
+      const Point2D::Value fallback = informed->Sample(0, ii, kInfinity);
+      const Point2D::Value expected = uniform->Sample(0, ii, kInfinity);
+      EXPECT_EQ(expected.x, fallback.x);
+      EXPECT_EQ(expected.y, fallback.y);
+
+      const Point2D::Value point = informed->Sample(0, ii, kBestCost);
+      EXPECT_TRUE(scene.IsInBounds(point));
+      EXPECT_LE(Point2D::DistancePointToPoint(point, origin) +
+                Point2D::DistancePointToPoint(point, goal), kBestCost + 1e-5);
+
+      const Point2D::Value loose = informed->Sample(0, ii, kLooseCost);
+      EXPECT_TRUE(scene.IsInBounds(loose));
+      EXPECT_LE(Point2D::DistancePointToPoint(loose, origin) +
+                Point2D::DistancePointToPoint(loose, goal), kLooseCost + 1e-5);
+    }
+  }
+
+  // Test that informed sampling finds a path at least as short as uniform
+  // sampling with the same number of samples.
+  TEST(InformedSampler2D, TestInformedRRTStar) {
+    math::RandomGenerator rng(0);
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 100; ii++) {
+      float x = rng.DoubleUniform(0.1, 0.9);
+      float y = rng.DoubleUniform(0.1, 0.9);
+      float radius = static_cast<float>(rng.DoubleUniform(0.01, 0.03));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+
+    Point2D::Ptr origin = Point2D::Create(0.02, 0.02);
+    Point2D::Ptr goal = Point2D::Create(0.98, 0.98);
+    ASSERT_TRUE(robot.IsFeasible(origin));
+    ASSERT_TRUE(robot.IsFeasible(goal));
+
+    RRTStarPlanner2D uniform(robot, scene, origin, goal, 0.05, 3000);
+    uniform.PlanTrajectory();
+
+    RRTStarPlanner2D informed(robot, scene, origin, goal, 0.05, 3000);
+    informed.SetSampler(
+      InformedSampler2D::Create(scene, Point2D::Value(*origin),
+                                Point2D::Value(*goal)));
+    informed.PlanTrajectory();
+
+    ASSERT_LT(uniform.GetBestCost(), std::numeric_limits<float>::infinity());
+    EXPECT_LE(informed.GetBestCost(), uniform.GetBestCost());
+  }
+
+  // Test that planners stop at the deadline or on cancellation with the best
+  // path so far, and give up after their sample budget when boxed in.
+  TEST(RRTStarPlanner2D, TestDeadlineAndCancel) {
+    // Ring the origin with obstacles so that the goal is unreachable.
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 64; ii++) {
+      const double angle = 2.0 * M_PI * ii / 64.0;
+      obstacles.push_back(Obstacle2D::Create(0.5 + 0.1 * std::cos(angle),
+                                             0.5 + 0.1 * std::sin(angle),
+                                             0.02));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.005);
+    Point2D::Ptr origin = Point2D::Create(0.5, 0.5);
+    Point2D::Ptr goal = Point2D::Create(0.9, 0.9);
+
+    RRTPlanner2D rrt(robot, scene, origin, goal, 0.02, 2000);
+    Trajectory2D::Ptr path;
+    EXPECT_EQ(Status::NOT_FOUND,
+              rrt.PlanTrajectory(util::Deadline::Never(), nullptr, path)
+              .ErrorCode());
+    ASSERT_TRUE(path != nullptr);
+    EXPECT_EQ(origin->x, path->GetX()[0]);
+
+    // Cancelled before starting.
+    util::CancellationToken::Ptr cancel = util::CancellationToken::Create();
+    cancel->Cancel();
+    RRTStarPlanner2D planner(robot, scene, origin, goal, 0.02, 1000000);
+    EXPECT_EQ(Status::CANCELLED,
+              planner.PlanTrajectory(util::Deadline::Never(), cancel, path)
+              .ErrorCode());
+
+    // A 50 ms budget is respected, and the path so far is returned.
+    util::Timer timer;
+    EXPECT_EQ(Status::DEADLINE_EXCEEDED,
+              planner.PlanTrajectory(util::Deadline::In(0.05), nullptr, path)
+              .ErrorCode());
+    EXPECT_LT(timer.Toc(), 0.5);
+    ASSERT_TRUE(path != nullptr);
+    EXPECT_GT(planner.GetTreeSize(), 1);
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), planner.GetBestCost());
+  }
+
+  // Test that the parallel RRT reaches the goal along a feasible path, and
+  // that its result does not depend on the number of threads.
+  TEST(ParallelRRTPlanner2D, TestParallelRRTPlanner2D) {
+    math::RandomGenerator rng(0);
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 200; ii++) {
+      float x = rng.DoubleUniform(0.1, 0.9);
+      float y = rng.DoubleUniform(0.1, 0.9);
+      float radius = static_cast<float>(rng.DoubleUniform(0.01, 0.02));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+    Point2D::Ptr origin = Point2D::Create(0.05, 0.05);
+    Point2D::Ptr goal = Point2D::Create(0.95, 0.95);
+
+    ParallelRRTPlanner2D planner(robot, scene, origin, goal, 0.02);
+    Trajectory2D::Ptr route;
+    ASSERT_TRUE(planner.PlanTrajectory(util::Deadline::Never(), nullptr,
+                                       route).ok());
+
+    ASSERT_GE(route->Size(), 2u);
+    EXPECT_EQ(goal->x, route->GetX()[route->Size() - 1]);
+    EXPECT_EQ(goal->y, route->GetY()[route->Size() - 1]);
+    for (size_t ii = 0; ii + 1 < route->Size(); ii++) {
+      EXPECT_TRUE(robot.LineOfSight(
+        Point2D::Value(route->GetX()[ii], route->GetY()[ii]),
+        Point2D::Value(route->GetX()[ii + 1], route->GetY()[ii + 1])));
+    }
+
+#ifdef _OPENMP
+    // Plan once on a single thread and once on several, and compare.
+    const int num_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    ParallelRRTPlanner2D serial(robot, scene, origin, goal, 0.02);
+    Trajectory2D::Ptr serial_route = serial.PlanTrajectory();
+
+    omp_set_num_threads(4);
+    ParallelRRTPlanner2D threaded(robot, scene, origin, goal, 0.02);
+    Trajectory2D::Ptr threaded_route = threaded.PlanTrajectory();
+    omp_set_num_threads(num_threads);
+
+    ASSERT_TRUE(serial_route != nullptr);
+    ASSERT_TRUE(threaded_route != nullptr);
+    ASSERT_EQ(serial_route->Size(), threaded_route->Size());
+    for (size_t ii = 0; ii < serial_route->Size(); ii++) {
+      EXPECT_EQ(serial_route->GetX()[ii], threaded_route->GetX()[ii]);
+      EXPECT_EQ(serial_route->GetY()[ii], threaded_route->GetY()[ii]);
+    }
+#endif
+  }
+
+  // Test that after an obstacle lands on the path, the repaired tree has no
+  // blocked edges, keeps most of its nodes, and leads around the obstacle.
+  TEST(IncrementalRRTPlanner2D, TestInvalidate) {
+    math::RandomGenerator rng(0);
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 200; ii++) {
+      float x = rng.DoubleUniform(0.1, 0.9);
+      float y = rng.DoubleUniform(0.1, 0.9);
+      float radius = static_cast<float>(rng.DoubleUniform(0.01, 0.02));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+    Point2D::Ptr origin = Point2D::Create(0.05, 0.05);
+    Point2D::Ptr goal = Point2D::Create(0.95, 0.95);
+
+    IncrementalRRTPlanner2D planner(robot, scene, origin, goal, 0.02);
+    Trajectory2D::Ptr route;
+    ASSERT_TRUE(planner.PlanTrajectory(util::Deadline::Never(), nullptr,
+                                       route).ok());
+
+    // Block the middle of the route.
+    const RRT2D& tree = planner.GetTree();
+    const Point2D::Value middle = route->GetValueAt(route->Size() / 2);
+    Obstacle2D::Ptr obstacle = Obstacle2D::Create(middle.x, middle.y, 0.05);
+    scene.AddObstacle(obstacle);
+    planner.Invalidate(*obstacle);
+
+    int num_live = 0;
+    for (int ii = 0; ii < tree.Size(); ii++) {
+      if (tree.IsRemoved(ii))
+        continue;
+
+      num_live++;
+      const Node2D& node = tree.GetNode(ii);
+      if (node.parent != Node2D::kNone) {
+        EXPECT_FALSE(tree.IsRemoved(node.parent));
+        EXPECT_TRUE(robot.LineOfSight(tree.GetPoint(node.parent), node.point));
+      }
+    }
+    EXPECT_GT(num_live, tree.Size() / 2);
+
+    ASSERT_TRUE(planner.PlanTrajectory(util::Deadline::Never(), nullptr,
+                                       route).ok());
+    EXPECT_EQ(goal->x, route->GetX()[route->Size() - 1]);
+    for (size_t ii = 0; ii + 1 < route->Size(); ii++) {
+      EXPECT_TRUE(robot.LineOfSight(route->GetValueAt(ii),
+                                    route->GetValueAt(ii + 1)));
+    }
+  }
+
+  // Test that grid A* finds the octile distance on an empty grid, and
+  // detours around an inflated wall.
+  TEST(GridAStarPlanner2D, TestWall) {
+    OccupancyGrid2D grid(0.0, 1.0, 0.0, 1.0, 0.01);
+    GridAStarPlanner2D planner(grid, 0.0);
+
+    // Cell (0, 0) is the top left corner.
+    const Point2D::Value origin = grid.GetCellCenter(99, 0);
+    const Point2D::Value goal = grid.GetCellCenter(60, 49);
+    Trajectory2D::Ptr route;
+    ASSERT_TRUE(planner.PlanTrajectory(origin, goal, route).ok());
+    EXPECT_NEAR(0.01 * (10.0 + 39.0 * std::sqrt(2.0)), planner.GetCost(),
+                1e-3);
+    EXPECT_EQ(origin.x, route->GetX()[0]);
+    EXPECT_EQ(goal.y, route->GetY()[route->Size() - 1]);
+
+    // Wall across x = 0.255, open only near the top.
+    for (float y = 0.005; y < 0.9; y += 0.01)
+      grid.Insert(Point2D::Create(0.255, y));
+
+    GridAStarPlanner2D wall_planner(grid, 0.02);
+    EXPECT_TRUE(wall_planner.IsBlocked(50, 23));
+    EXPECT_FALSE(wall_planner.IsBlocked(50, 22));
+    ASSERT_TRUE(wall_planner.PlanTrajectory(origin, goal, route).ok());
+    EXPECT_GT(wall_planner.GetCost(), planner.GetCost() + 1.0);
+    for (size_t ii = 0; ii < route->Size(); ii++) {
+      int row, col;
+      ASSERT_TRUE(grid.GetCell(route->GetValueAt(ii), row, col));
+      EXPECT_FALSE(wall_planner.IsBlocked(row, col));
+    }
+
+    // Closing the gap leaves no path.
+    for (float y = 0.905; y < 1.0; y += 0.01)
+      grid.Insert(Point2D::Create(0.255, y));
+    wall_planner.Inflate();
+    EXPECT_EQ(Status::NOT_FOUND,
+              wall_planner.PlanTrajectory(origin, goal, route).ErrorCode());
+    EXPECT_EQ(Status::INVALID_ARGUMENT,
+              wall_planner.PlanTrajectory(Point2D::Value(2.0, 0.0), goal,
+                                          route).ErrorCode());
+  }
+
+  // Test that Jump Point Search finds paths of the same cost as A* while
+  // expanding fewer cells.
+  TEST(GridAStarPlanner2D, TestJumpPointSearch) {
+    OccupancyGrid2D grid(0.0, 2.0, 0.0, 2.0, 0.01);
+    math::RandomGenerator rng(0);
+    for (size_t ii = 0; ii < 300; ii++)
+      grid.Insert(Point2D::Create(rng.DoubleUniform(0.0, 2.0),
+                                  rng.DoubleUniform(0.0, 2.0)));
+
+    GridAStarPlanner2D astar(grid, 0.01);
+    GridAStarPlanner2D jps(grid, 0.01);
+    jps.SetJumpPointSearch(true);
+
+    size_t num_found = 0, astar_expanded = 0, jps_expanded = 0;
+    for (size_t ii = 0; ii < 20; ii++) {
+      const Point2D::Value origin(rng.DoubleUniform(0.0, 2.0),
+                                  rng.DoubleUniform(0.0, 2.0));
+      const Point2D::Value goal(rng.DoubleUniform(0.0, 2.0),
+                                rng.DoubleUniform(0.0, 2.0));
+      Trajectory2D::Ptr astar_route, jps_route;
+      const Status status = astar.PlanTrajectory(origin, goal, astar_route);
+      EXPECT_EQ(status.ErrorCode(),
+                jps.PlanTrajectory(origin, goal, jps_route).ErrorCode());
+      if (!status.ok())
+        continue;
+
+      num_found++;
+      astar_expanded += astar.GetNumExpanded();
+      jps_expanded += jps.GetNumExpanded();
+      EXPECT_NEAR(astar.GetCost(), jps.GetCost(), 1e-3);
+
+      // The jump point path visits every cell along the way.
+      for (size_t jj = 1; jj + 2 < jps_route->Size(); jj++) {
+        const Point2D::Value from = jps_route->GetValueAt(jj);
+        const Point2D::Value to = jps_route->GetValueAt(jj + 1);
+        EXPECT_LT(std::fabs(to.x - from.x), 0.0101);
+        EXPECT_LT(std::fabs(to.y - from.y), 0.0101);
+
+        int row, col;
+        ASSERT_TRUE(grid.GetCell(to, row, col));
+        EXPECT_FALSE(jps.IsBlocked(row, col));
+      }
+    }
+
+    EXPECT_GT(num_found, 10u);
+    EXPECT_LT(5 * jps_expanded, astar_expanded);
+  }
+
+  // Test that one roadmap answers many queries with collision-free paths.
+  TEST(PRMPlanner2D, TestQueries) {
+    math::RandomGenerator rng(0);
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 100; ii++) {
+      float x = rng.DoubleUniform(0.1, 0.9);
+      float y = rng.DoubleUniform(0.1, 0.9);
+      float radius = static_cast<float>(rng.DoubleUniform(0.02, 0.04));
+      obstacles.push_back(Obstacle2D::Create(x, y, radius));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Robot2DCircular robot(scene, 0.01);
+    PRMPlanner2D planner(robot, scene, 2000, 0.1, 16);
+    planner.BuildRoadmap();
+    const size_t num_nodes = planner.GetNumNodes();
+    EXPECT_GT(num_nodes, 1000u);
+    EXPECT_GT(planner.GetNumEdges(), num_nodes);
+
+    size_t num_found = 0;
+    for (size_t ii = 0; ii < 50; ii++) {
+      const Point2D::Value origin(rng.DoubleUniform(0.0, 1.0),
+                                  rng.DoubleUniform(0.0, 1.0));
+      const Point2D::Value goal(rng.DoubleUniform(0.0, 1.0),
+                                rng.DoubleUniform(0.0, 1.0));
+      Trajectory2D::Ptr route;
+      const Status status = planner.PlanTrajectory(origin, goal, route);
+      if (!robot.IsFeasible(origin) || !robot.IsFeasible(goal)) {
+        EXPECT_EQ(Status::FAILED_PRECONDITION, status.ErrorCode());
+        continue;
+      }
+      if (!status.ok())
+        continue;
+
+      num_found++;
+      float length = 0.0;
+      for (size_t jj = 0; jj + 1 < route->Size(); jj++) {
+        EXPECT_TRUE(robot.LineOfSight(route->GetValueAt(jj),
+                                      route->GetValueAt(jj + 1)));
+        length += Point2D::DistancePointToPoint(route->GetValueAt(jj),
+                                                route->GetValueAt(jj + 1));
+      }
+      EXPECT_NEAR(length, planner.GetCost(), 1e-4);
+      EXPECT_GE(planner.GetCost(),
+                Point2D::DistancePointToPoint(origin, goal) - 1e-4);
+    }
+
+    EXPECT_GT(num_found, 10u);
+    EXPECT_EQ(num_nodes, planner.GetNumNodes());
+
+    // A lazy roadmap finds paths of the same cost.
+    PRMPlanner2D lazy(robot, scene, 2000, 0.1, 16);
+    lazy.SetLazyCollisionChecking(true);
+    for (size_t ii = 0; ii < 20; ii++) {
+      const Point2D::Value origin(rng.DoubleUniform(0.0, 1.0),
+                                  rng.DoubleUniform(0.0, 1.0));
+      const Point2D::Value goal(rng.DoubleUniform(0.0, 1.0),
+                                rng.DoubleUniform(0.0, 1.0));
+      Trajectory2D::Ptr route, lazy_route;
+      const Status status = planner.PlanTrajectory(origin, goal, route);
+      EXPECT_EQ(status.ErrorCode(),
+                lazy.PlanTrajectory(origin, goal, lazy_route).ErrorCode());
+      if (status.ok()) {
+        EXPECT_NEAR(planner.GetCost(), lazy.GetCost(), 1e-4);
+      }
+    }
+  }
+
 } //\ namespace path
@@ -63,4 +63,36 @@ namespace path {
     }
   }
 
+  // Test that the value and pointer versions of each helper agree.
+  TEST(Point2DHelpers, TestPoint2DValue) {
+    math::RandomGenerator rng(0);
+
+    for (size_t ii = 0; ii < 1000; ++ii) {
+      Point2D::Value value1(rng.Double(), rng.Double());
+      Point2D::Value value2(rng.Double(), rng.Double());
+      Point2D::Value value3(rng.Double(), rng.Double());
+      Point2D::Ptr point1 = Point2D::Create(value1);
+      Point2D::Ptr point2 = Point2D::Create(value2);
+      Point2D::Ptr point3 = Point2D::Create(value3);
+
+      EXPECT_EQ(Point2D::DistancePointToPoint(value1, value2),
+                Point2D::DistancePointToPoint(point1, point2));
+      EXPECT_EQ(Point2D::DistanceLineToPoint(value1, value2, value3),
+                Point2D::DistanceLineToPoint(point1, point2, point3));
+
+      Point2D::Value midpoint = Point2D::MidPoint(value1, value2);
+      EXPECT_EQ(midpoint.x, Point2D::MidPoint(point1, point2)->x);
+      EXPECT_EQ(midpoint.y, Point2D::MidPoint(point1, point2)->y);
+
+      Point2D::Value step = Point2D::StepToward(value1, value2, 0.1);
+      EXPECT_EQ(step.x, Point2D::StepToward(point1, point2, 0.1)->x);
+      EXPECT_EQ(step.y, Point2D::StepToward(point1, point2, 0.1)->y);
+
+      Point2D::Value sum = Point2D::Add(value1, value2, -1.0);
+      EXPECT_NEAR(sum.x, value1.x - value2.x, 1e-6);
+      EXPECT_NEAR(sum.y, value1.y - value2.y, 1e-6);
+      EXPECT_EQ(sum.y, Point2D::Add(point1, point2, -1.0)->y);
+    }
+  }
+
 } //\ namespace path
@@ -36,7 +36,9 @@
  */
 
 #include <math/random_generator.h>
+#include <math/counter_generator.h>
 
+#include <vector>
 #include <gtest/gtest.h>
 
 namespace path {
@@ -55,6 +57,31 @@ TEST(RandomGenerator, TestSeed) {
   }
 }
 
+TEST(RandomGenerator, TestIndependence) {
+  // Generators do not share state: drawing from or reseeding one leaves
+  // the sequence of another unchanged.
+  math::RandomGenerator rng1(7);
+  std::vector<double> expected;
+  for (int ii = 0; ii < 100; ++ii)
+    expected.push_back(rng1.Double());
+
+  math::RandomGenerator rng2(7);
+  for (int ii = 0; ii < 100; ++ii) {
+    math::RandomGenerator other(ii);
+    other.Double();
+    EXPECT_EQ(expected[ii], rng2.Double());
+  }
+
+  // Streams of one seed are reproducible and differ from each other.
+  math::RandomGenerator stream1(7, 1), stream1_again(7, 1), stream2(7, 2);
+  std::vector<double> doubles1, doubles1_again, doubles2;
+  stream1.Doubles(1000, &doubles1);
+  stream1_again.Doubles(1000, &doubles1_again);
+  stream2.Doubles(1000, &doubles2);
+  EXPECT_EQ(doubles1, doubles1_again);
+  EXPECT_NE(doubles1, doubles2);
+}
+
 TEST(RandomGenerator, TestUniform) {
   // Create a random generator.
   math::RandomGenerator rng(math::RandomGenerator::Seed());
@@ -159,4 +186,48 @@ TEST(RandomGenerator, TestGaussian) {
   EXPECT_NEAR(mean, sample_mean, 0.1);
 }
 
+TEST(CounterGenerator, TestKnownAnswers) {
+  // Known-answer vectors for Philox4x32-10 from the Random123 distribution.
+  const uint32_t zero_counter[4] = { 0, 0, 0, 0 };
+  const uint32_t zero_key[2] = { 0, 0 };
+  const uint32_t zero_block[4] =
+    { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+
+  const uint32_t pi_counter[4] =
+    { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  const uint32_t pi_key[2] = { 0xa4093822, 0x299f31d0 };
+  const uint32_t pi_block[4] =
+    { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+
+  uint32_t block[4];
+  math::CounterGenerator::Philox(zero_counter, zero_key, block);
+  for (int ii = 0; ii < 4; ++ii)
+    EXPECT_EQ(zero_block[ii], block[ii]);
+
+  math::CounterGenerator::Philox(pi_counter, pi_key, block);
+  for (int ii = 0; ii < 4; ++ii)
+    EXPECT_EQ(pi_block[ii], block[ii]);
+}
+
+TEST(CounterGenerator, TestPureFunction) {
+  // Samples depend only on (seed, stream, index), not on call order.
+  math::CounterGenerator generator(42);
+  std::vector<double> forward;
+  generator.DoublesUniform(3, 0, 1000, -1.0, 1.0, &forward);
+
+  double mean = 0.0;
+  for (int ii = 999; ii >= 0; --ii) {
+    const double sample = generator.DoubleUniform(3, ii, -1.0, 1.0);
+    EXPECT_EQ(forward[ii], sample);
+    EXPECT_LE(-1.0, sample);
+    EXPECT_GT(1.0, sample);
+    mean += sample / 1000.0;
+  }
+  EXPECT_NEAR(0.0, mean, 0.1);
+
+  // Other streams and seeds give other samples.
+  EXPECT_NE(generator.Double(3, 0), generator.Double(4, 0));
+  EXPECT_NE(generator.Double(3, 0), math::CounterGenerator(43).Double(3, 0));
+}
+
 }  //\namespace path
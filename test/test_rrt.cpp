@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+#include <geometry/rrt_2d.h>
+#include <geometry/node_2d.h>
+#include <geometry/point_2d.h>
+#include <math/random_generator.h>
+
+#include <vector>
+#include <limits>
+#include <gtest/gtest.h>
+
+namespace path {
+
+  // Test insertion, lookup, and path extraction on the arena-backed tree.
+  TEST(RRT2D, TestRRT2D) {
+    math::RandomGenerator rng(0);
+    RRT2D tree;
+
+    // The head is inserted at index 0 with no parent.
+    Point2D::Value head(0.5, 0.5);
+    EXPECT_EQ(tree.Insert(head), 0u);
+    EXPECT_EQ(tree.GetNode(0).parent, Node2D::kNone);
+
+    // Each new point is attached to its nearest neighbor.
+    std::vector<Point2D::Value> points(1, head);
+    for (size_t ii = 0; ii < 500; ++ii) {
+      Point2D::Value point(rng.Double(), rng.Double());
+
+      float min_distance = std::numeric_limits<float>::max();
+      Node2D::Index nearest = Node2D::kNone;
+      for (size_t jj = 0; jj < points.size(); ++jj) {
+        float distance = Point2D::DistancePointToPoint(point, points[jj]);
+        if (distance < min_distance) {
+          min_distance = distance;
+          nearest = jj;
+        }
+      }
+
+      Node2D::Index index = tree.Insert(point);
+      ASSERT_EQ(index, points.size());
+      EXPECT_EQ(tree.GetNode(index).parent, nearest);
+      points.push_back(point);
+    }
+
+    EXPECT_EQ(tree.Size(), points.size());
+
+    // Duplicates are rejected, and every point can be found again.
+    EXPECT_EQ(tree.Insert(points[10]), Node2D::kNone);
+    EXPECT_EQ(tree.Insert(points[10], 0), Node2D::kNone);
+    for (size_t ii = 0; ii < points.size(); ++ii)
+      EXPECT_EQ(tree.Find(points[ii]), ii);
+    EXPECT_FALSE(tree.Contains(Point2D::Value(2.0, 2.0)));
+
+    // The trajectory runs from the head to the goal along parent links.
+    Node2D::Index goal = points.size() - 1;
+    Trajectory2D::Ptr path = tree.GetTrajectory(goal);
+    ASSERT_TRUE(path != nullptr);
+    EXPECT_EQ(path->GetValueAt(0).x, head.x);
+    EXPECT_EQ(path->GetValueAt(path->Size() - 1).x, points[goal].x);
+
+    Node2D::Index child = goal;
+    for (size_t ii = path->Size() - 1; ii > 0; --ii) {
+      Node2D::Index parent = tree.GetNode(child).parent;
+      EXPECT_EQ(path->GetValueAt(ii - 1).y, tree.GetPoint(parent).y);
+      child = parent;
+    }
+  }
+
+  // Test that reparenting moves a node between child lists.
+  TEST(RRT2D, TestSetParent) {
+    RRT2D tree;
+    tree.Insert(Point2D::Value(0.0, 0.0));
+    tree.Insert(Point2D::Value(1.0, 0.0), 0);
+    tree.Insert(Point2D::Value(2.0, 0.0), 1);
+    tree.Insert(Point2D::Value(1.0, 1.0), 1);
+
+    // Node 2 moves from node 1 to the head; node 3 stays under node 1.
+    tree.SetParent(2, 0);
+    EXPECT_EQ(tree.GetNode(2).parent, 0u);
+    EXPECT_EQ(tree.GetNode(1).first_child, 3u);
+    EXPECT_EQ(tree.GetNode(3).next_sibling, Node2D::kNone);
+    EXPECT_EQ(tree.GetTrajectory(2)->Size(), 2u);
+
+    std::vector<Node2D::Index> neighbors;
+    tree.RadiusSearch(Point2D::Value(1.0, 0.0), 1.01, neighbors);
+    EXPECT_EQ(neighbors.size(), 4u);
+  }
+
+  // Test that a segment is inserted as a chain ending at the target.
+  TEST(RRT2D, TestInsertSegment) {
+    RRT2D tree;
+    tree.Insert(Point2D::Value(0.0, 0.0));
+
+    Node2D::Index end = tree.InsertSegment(0, Point2D::Value(1.0, 0.0), 0.3);
+    ASSERT_NE(end, Node2D::kNone);
+    EXPECT_EQ(tree.Size(), 5u);
+    EXPECT_EQ(tree.GetPoint(end).x, 1.0);
+    EXPECT_EQ(tree.GetTrajectory(end)->Size(), 5u);
+  }
+
+} //\ namespace path
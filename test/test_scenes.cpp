@@ -37,10 +37,13 @@
 #include <geometry/trajectory_2d.h>
 #include <geometry/point_2d.h>
 #include <math/random_generator.h>
+#include <robot/robot_2d_circular.h>
 #include <scene/scene_2d_continuous.h>
 #include <scene/obstacle_2d.h>
+#include <scene/obstacle_set_2d.h>
 #include <image/image.h>
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
 #include <gtest/gtest.h>
@@ -124,4 +127,254 @@ namespace path {
     }
   }
 
+  // Test that the uniform grid index agrees with the kd tree.
+  TEST(Scene2DContinuous, TestUniformGridIndex) {
+    math::RandomGenerator rng(0);
+
+    // Create a bunch of obstacles, a few of them outside the bounds and a
+    // few much larger than the rest.
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 200; ii++) {
+      float x = rng.DoubleUniform(-0.1, 1.1);
+      float y = rng.DoubleUniform(-0.1, 1.1);
+      float scale = (ii % 40 == 0) ? 0.05 : 0.0005;
+      float sigma_xx = scale * rng.DoubleUniform(0.25, 0.75);
+      float sigma_yy = scale * rng.DoubleUniform(0.25, 0.75);
+      float sigma_xy = rng.Double() * std::sqrt(sigma_xx * sigma_yy);
+
+      obstacles.push_back(
+        Obstacle2D::Create(x, y, sigma_xx, sigma_yy, sigma_xy, 3.0));
+    }
+
+    // Build half in bulk and add the rest one at a time.
+    std::vector<Obstacle2D::Ptr> first_half(obstacles.begin(),
+                                            obstacles.begin() + 100);
+    Scene2DContinuous tree_scene(0.0, 1.0, 0.0, 1.0, first_half);
+    Scene2DContinuous grid_scene(0.0, 1.0, 0.0, 1.0, first_half,
+                                 Scene2DContinuous::UNIFORM_GRID);
+    for (size_t ii = 100; ii < obstacles.size(); ii++) {
+      tree_scene.AddObstacle(obstacles[ii]);
+      grid_scene.AddObstacle(obstacles[ii]);
+    }
+
+    EXPECT_EQ(grid_scene.GetIndexType(), Scene2DContinuous::UNIFORM_GRID);
+    EXPECT_EQ(tree_scene.GetLargestObstacleRadius(),
+              grid_scene.GetLargestObstacleRadius());
+
+    const ObstacleIndex2D& tree = tree_scene.GetObstacleIndex();
+    const ObstacleIndex2D& grid = grid_scene.GetObstacleIndex();
+    EXPECT_EQ(tree.Size(), grid.Size());
+
+    for (size_t ii = 0; ii < 500; ii++) {
+      Point2D::Value query(rng.DoubleUniform(-0.5, 1.5),
+                           rng.DoubleUniform(-0.5, 1.5));
+
+      int tree_nearest = -1, grid_nearest = -1;
+      float tree_distance = -1.0, grid_distance = -1.0;
+      EXPECT_TRUE(tree.NearestNeighbor(query, tree_nearest, tree_distance));
+      EXPECT_TRUE(grid.NearestNeighbor(query, grid_nearest, grid_distance));
+      EXPECT_NEAR(tree_distance, grid_distance, 1e-6);
+
+      std::vector<int> tree_neighbors, grid_neighbors;
+      tree.RadiusSearch(query, tree_neighbors, 0.1);
+      grid.RadiusSearch(query, grid_neighbors, 0.1);
+      std::sort(tree_neighbors.begin(), tree_neighbors.end());
+      std::sort(grid_neighbors.begin(), grid_neighbors.end());
+      EXPECT_EQ(tree_neighbors, grid_neighbors);
+
+      // Extent search against brute force.
+      std::vector<int> expected;
+      for (size_t jj = 0; jj < obstacles.size(); jj++) {
+        if (Point2D::DistancePointToPoint(query,
+                                          obstacles[jj]->GetLocationValue()) <=
+            0.01 + 2.0 * obstacles[jj]->GetRadius())
+          expected.push_back(static_cast<int>(jj));
+      }
+
+      tree.ExtentSearch(query, 0.01, 2.0, tree_neighbors);
+      grid.ExtentSearch(query, 0.01, 2.0, grid_neighbors);
+      std::sort(tree_neighbors.begin(), tree_neighbors.end());
+      std::sort(grid_neighbors.begin(), grid_neighbors.end());
+      EXPECT_EQ(expected, tree_neighbors);
+      EXPECT_EQ(expected, grid_neighbors);
+
+      EXPECT_EQ(tree_scene.IsFeasible(query), grid_scene.IsFeasible(query));
+      EXPECT_NEAR(tree_scene.Cost(query), grid_scene.Cost(query),
+                  1e-4 * (1.0 + tree_scene.Cost(query)));
+    }
+  }
+
+  // Test that the packed cost kernel matches per-obstacle evaluation.
+  TEST(Scene2DContinuous, TestObstacleSet) {
+    math::RandomGenerator rng(0);
+
+    std::vector<Obstacle2D::Ptr> obstacles;
+    ObstacleSet2D obstacle_set;
+    for (size_t ii = 0; ii < 37; ii++) {
+      float x = rng.Double();
+      float y = rng.Double();
+      float sigma_xx = 0.005 * rng.DoubleUniform(0.25, 0.75);
+      float sigma_yy = 0.005 * rng.DoubleUniform(0.25, 0.75);
+      float sigma_xy = rng.Double() * std::sqrt(sigma_xx * sigma_yy);
+
+      obstacles.push_back(
+        Obstacle2D::Create(x, y, sigma_xx, sigma_yy, sigma_xy, 3.0));
+      obstacle_set.AddObstacle(*obstacles.back());
+    }
+    EXPECT_EQ(obstacle_set.Size(), obstacles.size());
+
+    std::vector<Point2D::Value> points;
+    for (size_t ii = 0; ii < 100; ii++)
+      points.push_back(Point2D::Value(rng.Double(), rng.Double()));
+
+    std::vector<float> costs;
+    std::vector<Point2D::Value> derivatives;
+    obstacle_set.Cost(points, costs, &derivatives);
+
+    // Every third obstacle, to exercise a partial last group.
+    std::vector<int> subset;
+    for (size_t ii = 0; ii < obstacles.size(); ii += 3)
+      subset.push_back(static_cast<int>(ii));
+
+    for (size_t ii = 0; ii < points.size(); ii++) {
+      float expected_cost = 0.0, expected_dx = 0.0, expected_dy = 0.0;
+      float subset_cost = 0.0;
+      for (size_t jj = 0; jj < obstacles.size(); jj++) {
+        expected_cost += obstacles[jj]->Cost(points[ii]);
+        Point2D::Value derivative = obstacles[jj]->Derivative(points[ii]);
+        expected_dx += derivative.x;
+        expected_dy += derivative.y;
+        if (jj % 3 == 0)
+          subset_cost += obstacles[jj]->Cost(points[ii]);
+      }
+
+      EXPECT_NEAR(expected_cost, costs[ii], 1e-4 * (1.0 + expected_cost));
+      EXPECT_NEAR(expected_dx, derivatives[ii].x,
+                  1e-3 * (1.0 + std::abs(expected_dx)));
+      EXPECT_NEAR(expected_dy, derivatives[ii].y,
+                  1e-3 * (1.0 + std::abs(expected_dy)));
+      EXPECT_NEAR(subset_cost,
+                  obstacle_set.Cost(points[ii], subset.data(), subset.size()),
+                  1e-4 * (1.0 + subset_cost));
+    }
+  }
+
+  // Test that the cached cost field tracks the exact cost.
+  TEST(Scene2DContinuous, TestCostCache) {
+    math::RandomGenerator rng(0);
+
+    // Use a large z-score so the cost cutoff lies far out in the tail, where
+    // the exact cost is smooth enough to interpolate.
+    std::vector<Obstacle2D::Ptr> obstacles;
+    for (size_t ii = 0; ii < 10; ii++) {
+      obstacles.push_back(Obstacle2D::Create(rng.Double(), rng.Double(),
+                                             0.005, 0.005, 0.0, 10.0));
+    }
+
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    Scene2DContinuous cached_scene(0.0, 1.0, 0.0, 1.0, obstacles);
+    cached_scene.EnableCostCache(0.002, 16);
+    EXPECT_TRUE(cached_scene.IsCostCacheEnabled());
+
+    for (size_t ii = 0; ii < 200; ii++) {
+      Point2D::Value point(rng.DoubleUniform(-0.1, 1.1),
+                           rng.DoubleUniform(-0.1, 1.1));
+      const float cost = scene.Cost(point);
+      EXPECT_NEAR(cost, cached_scene.Cost(point), 1e-2 * (1.0 + cost));
+
+      Point2D::Value derivative = scene.CostDerivative(point);
+      Point2D::Value cached = cached_scene.CostDerivative(point);
+      const float scale = 1.0 + std::abs(derivative.x) + std::abs(derivative.y);
+      EXPECT_NEAR(derivative.x, cached.x, 5e-2 * scale);
+      EXPECT_NEAR(derivative.y, cached.y, 5e-2 * scale);
+    }
+
+    // Adding an obstacle must show up in previously cached tiles.
+    Point2D::Value center(0.5, 0.5);
+    const float before = cached_scene.Cost(center);
+    Obstacle2D::Ptr obstacle =
+      Obstacle2D::Create(center.x, center.y, 0.005, 0.005, 0.0, 10.0);
+    scene.AddObstacle(obstacle);
+    cached_scene.AddObstacle(obstacle);
+    EXPECT_GT(cached_scene.Cost(center), before);
+    EXPECT_NEAR(scene.Cost(center), cached_scene.Cost(center),
+                1e-2 * (1.0 + scene.Cost(center)));
+  }
+
+  // Test that indexed random points stay in bounds and depend only on the
+  // sample seed, stream and index.
+  TEST(Scene2DContinuous, TestIndexedRandomPoints) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(-1.0, 2.0, 0.5, 1.5, obstacles);
+    Scene2DContinuous other(-1.0, 2.0, 0.5, 1.5, obstacles);
+    EXPECT_EQ(0u, scene.GetSampleSeed());
+
+    scene.SetSampleSeed(7);
+    other.SetSampleSeed(7);
+    EXPECT_EQ(7u, scene.GetSampleSeed());
+
+    const uint64_t kNumSamples = 100;
+    std::vector<Point2D::Value> stream0, stream1;
+    for (uint64_t ii = 0; ii < kNumSamples; ii++) {
+      const Point2D::Value point = scene.GetRandomPointValue(0, ii);
+      EXPECT_GE(point.x, -1.0);
+      EXPECT_LE(point.x, 2.0);
+      EXPECT_GE(point.y, 0.5);
+      EXPECT_LE(point.y, 1.5);
+      stream0.push_back(point);
+      stream1.push_back(scene.GetRandomPointValue(1, ii));
+    }
+
+    // Same seed, stream and index give the same point, in any order and on
+    // any scene.
+    for (uint64_t ii = kNumSamples; ii-- > 0; ) {
+      const Point2D::Value point = other.GetRandomPointValue(0, ii);
+      EXPECT_EQ(stream0[ii].x, point.x);
+      EXPECT_EQ(stream0[ii].y, point.y);
+
+      const Point2D::Ptr ptr = scene.GetRandomPoint(1, ii);
+      EXPECT_EQ(stream1[ii].x, ptr->x);
+      EXPECT_EQ(stream1[ii].y, ptr->y);
+    }
+
+    // A different stream, or a different seed, gives a different sequence.
+    other.SetSampleSeed(8);
+    size_t num_stream_equal = 0, num_seed_equal = 0;
+    for (uint64_t ii = 0; ii < kNumSamples; ii++) {
+      if (stream0[ii].x == stream1[ii].x && stream0[ii].y == stream1[ii].y)
+        num_stream_equal++;
+
+      const Point2D::Value point = other.GetRandomPointValue(0, ii);
+      if (stream0[ii].x == point.x && stream0[ii].y == point.y)
+        num_seed_equal++;
+    }
+    EXPECT_EQ(0u, num_stream_equal);
+    EXPECT_EQ(0u, num_seed_equal);
+  }
+
+  // Test that a large obstacle blocks a point even when a smaller obstacle
+  // has the nearer center.
+  TEST(Robot2DCircular, TestMixedRadii) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    obstacles.push_back(Obstacle2D::Create(0.5, 0.5, 0.3));
+    obstacles.push_back(Obstacle2D::Create(0.75, 0.5, 0.01));
+
+    const Scene2DContinuous::IndexType index_types[2] = {
+      Scene2DContinuous::KD_TREE, Scene2DContinuous::UNIFORM_GRID
+    };
+    for (size_t ii = 0; ii < 2; ii++) {
+      Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles, index_types[ii]);
+      Robot2DCircular robot(scene, 0.01);
+      EXPECT_FALSE(robot.IsFeasible(Point2D::Value(0.78, 0.5)));
+      EXPECT_TRUE(robot.IsFeasible(Point2D::Value(0.9, 0.5)));
+
+      std::vector<Point2D::Value> waypoints;
+      waypoints.push_back(Point2D::Value(0.9, 0.5));
+      waypoints.push_back(Point2D::Value(0.78, 0.5));
+      Trajectory2D::Ptr path = Trajectory2D::Create(waypoints);
+      EXPECT_FALSE(robot.IsFeasible(*path));
+      EXPECT_FALSE(robot.IsFeasible(*path, true));
+    }
+  }
+
 } //\ namespace path
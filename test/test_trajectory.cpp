@@ -83,4 +83,36 @@ namespace path {
     EXPECT_NEAR(path2->GetLength(), length, 1e-8);
   }
 
+  // Test upsampling and time derivatives on the contiguous storage.
+  TEST(Trajectory2D, TestUpsampleAndDerivative) {
+    math::RandomGenerator rng(0);
+
+    Trajectory2D::Ptr path = Trajectory2D::Create();
+    for (size_t ii = 0; ii < 100; ++ii)
+      path->AddPoint(Point2D::Value(rng.Double(), rng.Double()));
+
+    const double length = path->GetLength();
+    const Point2D::Value first = path->GetValueAt(0);
+    const Point2D::Value last = path->GetValueAt(path->Size() - 1);
+
+    // Upsampling keeps the endpoints and the length of the path.
+    path->Upsample(4);
+    EXPECT_EQ(path->Size(), 99 * 5 + 1);
+    EXPECT_EQ(path->GetValueAt(0).x, first.x);
+    EXPECT_EQ(path->GetValueAt(path->Size() - 1).y, last.y);
+    path->RecomputeLength();
+    EXPECT_NEAR(path->GetLength(), length, 1e-4);
+
+    // Symmetric differences in the middle, one-sided at the ends.
+    Trajectory2D::Ptr derivative = path->TimeDerivative();
+    ASSERT_EQ(derivative->Size(), path->Size());
+    EXPECT_NEAR(derivative->GetX()[0], path->GetX()[1] - path->GetX()[0], 1e-6);
+    for (size_t ii = 1; ii < path->Size() - 1; ++ii) {
+      EXPECT_NEAR(derivative->GetX()[ii],
+                  0.5 * (path->GetX()[ii + 1] - path->GetX()[ii - 1]), 1e-6);
+      EXPECT_NEAR(derivative->GetY()[ii],
+                  0.5 * (path->GetY()[ii + 1] - path->GetY()[ii - 1]), 1e-6);
+    }
+  }
+
 } //\ namespace path
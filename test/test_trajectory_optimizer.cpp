@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ *          Erik Nelson            ( eanelson@eecs.berkeley.edu )
+ */
+
+#include <optimization/trajectory_optimizer_2d.h>
+#include <optimization/covariant_optimizer_2d.h>
+#include <optimization/multi_resolution_optimizer_2d.h>
+#include <geometry/trajectory_2d.h>
+#include <geometry/point_2d.h>
+#include <scene/scene_2d_continuous.h>
+#include <scene/obstacle_2d.h>
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace path {
+
+  namespace {
+
+    // Weighted objective that TrajectoryOptimizer2D minimizes.
+    float Objective(const Scene2DContinuous& scene, const Trajectory2D& path,
+                    float cost_weight, float smoothness_weight) {
+      const float* x = path.GetX();
+      const float* y = path.GetY();
+      float objective = 0.0;
+      for (size_t ii = 0; ii + 1 < path.Size(); ii++) {
+        if (ii > 0)
+          objective += cost_weight * scene.Cost(Point2D::Value(x[ii], y[ii]));
+        const float dx = x[ii + 1] - x[ii];
+        const float dy = y[ii + 1] - y[ii];
+        objective += 0.5 * smoothness_weight * (dx * dx + dy * dy);
+      }
+      return objective;
+    }
+
+  } //\ namespace
+
+  // Without obstacles, a zig-zag relaxes to evenly spaced points on the
+  // segment between its fixed endpoints.
+  TEST(TrajectoryOptimizer2D, TestStraightensFreePath) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const size_t kNumPoints = 21;
+    std::vector<float> x(kNumPoints), y(kNumPoints);
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      x[ii] = static_cast<float>(ii) / (kNumPoints - 1);
+      y[ii] = 0.5 + ((ii % 2 == 0) ? 0.1 : -0.1);
+    }
+    y[0] = y[kNumPoints - 1] = 0.5;
+
+    TrajectoryOptimizer2D optimizer(scene, 1.0, 1.0);
+    Trajectory2D::Ptr optimized =
+      optimizer.Optimize(Trajectory2D::Create(x, y), 50, 1e-8);
+
+    ASSERT_EQ(kNumPoints, optimized->Size());
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      EXPECT_NEAR(x[ii], optimized->GetX()[ii], 1e-4);
+      EXPECT_NEAR(0.5, optimized->GetY()[ii], 1e-4);
+    }
+  }
+
+  // A straight path grazing an obstacle is pushed away from it, lowering
+  // the objective while keeping its endpoints.
+  TEST(TrajectoryOptimizer2D, TestAvoidsObstacle) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    obstacles.push_back(Obstacle2D::Create(0.5, 0.45, 0.005, 0.005, 0.0, 10.0));
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const size_t kNumPoints = 41;
+    std::vector<float> x(kNumPoints), y(kNumPoints, 0.5);
+    for (size_t ii = 0; ii < kNumPoints; ii++)
+      x[ii] = 0.1 + 0.8 * static_cast<float>(ii) / (kNumPoints - 1);
+    Trajectory2D::Ptr path = Trajectory2D::Create(x, y);
+
+    const float kCostWeight = 1e-3;
+    const float kSmoothnessWeight = 1.0;
+    TrajectoryOptimizer2D optimizer(scene, kCostWeight, kSmoothnessWeight);
+    Trajectory2D::Ptr optimized = optimizer.Optimize(path);
+
+    ASSERT_EQ(kNumPoints, optimized->Size());
+    EXPECT_FLOAT_EQ(x.front(), optimized->GetX()[0]);
+    EXPECT_FLOAT_EQ(x.back(), optimized->GetX()[kNumPoints - 1]);
+    EXPECT_FLOAT_EQ(0.5, optimized->GetY()[0]);
+    EXPECT_FLOAT_EQ(0.5, optimized->GetY()[kNumPoints - 1]);
+
+    EXPECT_GT(optimized->GetY()[kNumPoints / 2], 0.5);
+    EXPECT_LT(Objective(scene, *optimized, kCostWeight, kSmoothnessWeight),
+              Objective(scene, *path, kCostWeight, kSmoothnessWeight));
+
+    // Evaluating waypoints in parallel gives the same path, up to the
+    // rounding of partial sums combined in a different order.
+    Trajectory2D::Ptr parallel =
+      optimizer.Optimize(path, 100, 1e-4, true /* parallel */);
+    ASSERT_EQ(kNumPoints, parallel->Size());
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      EXPECT_NEAR(optimized->GetX()[ii], parallel->GetX()[ii],
+                  1e-4 * std::fabs(optimized->GetX()[ii]));
+      EXPECT_NEAR(optimized->GetY()[ii], parallel->GetY()[ii],
+                  1e-4 * std::fabs(optimized->GetY()[ii]));
+    }
+  }
+
+  // With a unit step, covariant descent reaches the smoothest path through
+  // free space in a single iteration.
+  TEST(CovariantOptimizer2D, TestStraightensFreePath) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const size_t kNumPoints = 21;
+    std::vector<float> x(kNumPoints), y(kNumPoints);
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      x[ii] = static_cast<float>(ii) / (kNumPoints - 1);
+      y[ii] = 0.5 + ((ii % 2 == 0) ? 0.1 : -0.1);
+    }
+    y[0] = y[kNumPoints - 1] = 0.5;
+
+    CovariantOptimizer2D optimizer(scene, 1.0, 1.0, 1.0, 1.0);
+    Trajectory2D::Ptr optimized =
+      optimizer.Optimize(Trajectory2D::Create(x, y), 1);
+
+    ASSERT_EQ(kNumPoints, optimized->Size());
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      EXPECT_NEAR(x[ii], optimized->GetX()[ii], 1e-5);
+      EXPECT_NEAR(0.5, optimized->GetY()[ii], 1e-5);
+    }
+  }
+
+  // A step capped by the maximum point displacement that still overshoots is
+  // halved on rejection, rather than rebuilt at the same capped size.
+  TEST(CovariantOptimizer2D, TestBacktracksCappedStep) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const size_t kNumPoints = 21;
+    std::vector<float> x(kNumPoints), y(kNumPoints);
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      x[ii] = static_cast<float>(ii) / (kNumPoints - 1);
+      y[ii] = 0.5 + ((ii % 2 == 0) ? 0.1 : -0.1);
+    }
+    y[0] = y[kNumPoints - 1] = 0.5;
+
+    // Sum of squared segment lengths, the whole objective in free space.
+    auto smoothness = [](const Trajectory2D::Ptr& path) {
+      double sum = 0.0;
+      for (size_t ii = 0; ii + 1 < path->Size(); ii++) {
+        const double dx = path->GetX()[ii + 1] - path->GetX()[ii];
+        const double dy = path->GetY()[ii + 1] - path->GetY()[ii];
+        sum += dx * dx + dy * dy;
+      }
+      return sum;
+    };
+
+    // The full step moves each waypoint by 0.1. A step size of 16 is capped
+    // to 3 times that, which overshoots the straight line.
+    CovariantOptimizer2D optimizer(scene, 1.0, 1.0, 16.0, 0.3);
+    Trajectory2D::Ptr path = Trajectory2D::Create(x, y);
+    Trajectory2D::Ptr optimized = optimizer.Optimize(path, 2);
+
+    ASSERT_EQ(kNumPoints, optimized->Size());
+    EXPECT_LT(smoothness(optimized), smoothness(path));
+    for (size_t ii = 0; ii < kNumPoints; ii++)
+      EXPECT_NEAR(0.5, optimized->GetY()[ii], 0.05 + 1e-5);
+  }
+
+  // Covariant descent converges to the least-squares optimum within a few
+  // tens of iterations.
+  TEST(CovariantOptimizer2D, TestMatchesLeastSquares) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    obstacles.push_back(Obstacle2D::Create(0.5, 0.45, 0.005, 0.005, 0.0, 10.0));
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    const size_t kNumPoints = 41;
+    std::vector<float> x(kNumPoints), y(kNumPoints, 0.5);
+    for (size_t ii = 0; ii < kNumPoints; ii++)
+      x[ii] = 0.1 + 0.8 * static_cast<float>(ii) / (kNumPoints - 1);
+    Trajectory2D::Ptr path = Trajectory2D::Create(x, y);
+
+    const float kCostWeight = 1e-3;
+    const float kSmoothnessWeight = 1.0;
+    TrajectoryOptimizer2D least_squares(scene, kCostWeight, kSmoothnessWeight);
+    Trajectory2D::Ptr expected = least_squares.Optimize(path, 100, 1e-8);
+
+    CovariantOptimizer2D covariant(scene, kCostWeight, kSmoothnessWeight,
+                                   0.5, 0.05);
+    Trajectory2D::Ptr optimized = covariant.Optimize(path, 50, 1e-7);
+
+    ASSERT_EQ(kNumPoints, optimized->Size());
+    for (size_t ii = 0; ii < kNumPoints; ii++) {
+      EXPECT_NEAR(expected->GetX()[ii], optimized->GetX()[ii], 1e-3);
+      EXPECT_NEAR(expected->GetY()[ii], optimized->GetY()[ii], 1e-3);
+    }
+  }
+
+  // Coarse-to-fine optimization of a sparse path reaches the same optimum
+  // as optimizing its upsampled version directly.
+  TEST(MultiResolutionOptimizer2D, TestMatchesFullResolution) {
+    std::vector<Obstacle2D::Ptr> obstacles;
+    obstacles.push_back(Obstacle2D::Create(0.5, 0.45, 0.005, 0.005, 0.0, 10.0));
+    Scene2DContinuous scene(0.0, 1.0, 0.0, 1.0, obstacles);
+
+    std::vector<float> x = {0.1, 0.3, 0.5, 0.7, 0.9};
+    std::vector<float> y(x.size(), 0.5);
+
+    const float kCostWeight = 1e-4;
+    const float kSmoothnessWeight = 10.0;
+    MultiResolutionOptimizer2D multi_resolution(scene, kCostWeight,
+                                                kSmoothnessWeight, 3, 3,
+                                                0.5, 0.05);
+    Trajectory2D::Ptr optimized =
+      multi_resolution.Optimize(Trajectory2D::Create(x, y), 50, 1e-7);
+
+    Trajectory2D::Ptr upsampled = Trajectory2D::Create(x, y);
+    upsampled->Upsample(15);
+    CovariantOptimizer2D covariant(scene, kCostWeight, kSmoothnessWeight,
+                                   0.5, 0.05);
+    Trajectory2D::Ptr expected = covariant.Optimize(upsampled, 200, 1e-7);
+
+    ASSERT_EQ(expected->Size(), optimized->Size());
+    EXPECT_GT(optimized->GetY()[optimized->Size() / 2], 0.52);
+    for (size_t ii = 0; ii < expected->Size(); ii++) {
+      EXPECT_NEAR(expected->GetX()[ii], optimized->GetX()[ii], 1e-3);
+      EXPECT_NEAR(expected->GetY()[ii], optimized->GetY()[ii], 1e-3);
+    }
+  }
+
+} //\ namespace path